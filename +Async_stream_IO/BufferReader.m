@@ -0,0 +1,62 @@
+classdef BufferReader<handle
+	%从内存中的字节缓冲顺序读出数据，读取语法与AsyncSerialStream.Read相同
+	%用于先将分块到达的多个报文拼接完整，再按原样解析的场合。
+	%See also Async_stream_IO.AsyncSerialStream.Read
+	properties(SetAccess=immutable)
+		%要读取的字节
+		Buffer
+	end
+	properties(SetAccess=protected)
+		%已读出的字节数
+		Position=0
+	end
+	methods
+		function obj = BufferReader(Buffer)
+			%# 语法
+			% ```
+			% obj = Async_stream_IO.BufferReader(Buffer);
+			% ```
+			%# 输入参数
+			% Buffer(:,1)uint8，要读取的字节
+			obj.Buffer=uint8(Buffer(:));
+		end
+		function Data=Read(obj,varargin)
+			%从缓冲读出数据类型
+			%# 语法
+			% ```
+			% Data=Read(obj);
+			% %读入一个字节
+			%
+			% Data=Read(obj,Type);
+			% %读入1个指定类型的数据
+			%
+			% Data=Read(obj,Number);
+			% %读入指定数量的uint8
+			%
+			% Data=Read(obj,Number,Type);
+			% %读入指定数量的指定类型的数据
+			% ```
+			%# 输入参数
+			% Number(1,1)=1，要读取的数据数量
+			% Type(1,1)string="uint8"，要读取的数据类型，注意不同类型数据有不同的字节数
+			%# 返回值
+			% Data(1,Number)Type，读取到的数据。缓冲剩余字节不足时将抛出Corrupted_object_received异常。
+			Number=1;
+			Type='uint8';
+			for V=1:numel(varargin)
+				Arg=varargin{V};
+				if isnumeric(Arg)
+					Number=double(Arg);
+				else
+					Type=Arg;
+				end
+			end
+			NumBytes=Number*numel(typecast(zeros(1,1,Type),'uint8'));
+			if obj.Position+NumBytes>numel(obj.Buffer)
+				Async_stream_IO.Exception.Corrupted_object_received.Throw(sprintf('Position %u, NumBytes %u, BufferSize %u',obj.Position,NumBytes,numel(obj.Buffer)));
+			end
+			Data=typecast(obj.Buffer(obj.Position+1:obj.Position+NumBytes).',Type);
+			obj.Position=obj.Position+NumBytes;
+		end
+	end
+end
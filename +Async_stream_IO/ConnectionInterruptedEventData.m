@@ -1,11 +1,11 @@
-classdef(ConstructOnLoad)ConnectionInterruptedEventData<event.EventData
-	%断线重连或连接失败时抛出异常事件
-	properties
-		Exception
-	end
-	methods
-		function obj = ConnectionInterruptedEventData(Exception)
-			obj.Exception = Exception;
-		end
-	end
+classdef(ConstructOnLoad)ConnectionInterruptedEventData<event.EventData
+	%断线重连或连接失败时抛出异常事件
+	properties
+		Exception
+	end
+	methods
+		function obj = ConnectionInterruptedEventData(Exception)
+			obj.Exception = Exception;
+		end
+	end
 end
\ No newline at end of file
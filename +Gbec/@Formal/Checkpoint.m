@@ -0,0 +1,28 @@
+%[text] 取得会话当前执行位置的断点
+%[text] 断点记录了设备端执行路径上各模块的位置和随机数发生器的状态，只有几十字节。断线重连时，如果当前回合内取得过断点，RestoreSession将从断点处继续执行，不会重做当前回合已执行的部分。可以在实验过程中定期调用此方法。
+%[text] ## 示例
+%[text] ```matlabCodeExample
+%[text] %每5秒取得一次断点
+%[text] T=timer(Period=5,ExecutionMode='fixedSpacing',TimerFcn=@(~,~)Formal3.Checkpoint);
+%[text] T.start;
+%[text] ```
+function Checkpoint(obj)
+if obj.State==Gbec.UID.State_Idle
+	Gbec.Exception.Process_not_running.Throw;
+end
+AsyncStream=obj.Server.AsyncStream;
+LocalPort=AsyncStream.AllocatePort;
+OCU=onCleanup(@()AsyncStream.ReleasePort(LocalPort));
+TCO=Async_stream_IO.TemporaryCallbackOff(AsyncStream);
+AsyncStream.BeginSend(Gbec.UID.PortA_GetCheckpoint,obj.Server.PointerSize+1);
+AsyncStream<=LocalPort<=obj.Pointer;
+NumBytes=AsyncStream.Listen(LocalPort);
+if NumBytes==1
+	obj.ThrowResult(AsyncStream.Read);
+end
+obj.LastCheckpoint=AsyncStream.Read(NumBytes).';
+obj.CheckpointTrial=obj.TrialIndex;
+end
+
+%[appendix]{"version":"1.0"}
+%---
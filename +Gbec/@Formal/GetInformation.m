@@ -16,172 +16,179 @@ OCU=onCleanup(@()AsyncStream.ReleasePort(LocalPort));
 TCO=Async_stream_IO.TemporaryCallbackOff(AsyncStream);
 AsyncStream.BeginSend(Gbec.UID.PortA_GetInformation,obj.Server.PointerSize+1);
 AsyncStream<=LocalPort<=obj.Pointer;
-AsyncStream.Listen(LocalPort);
-Information=CollectStruct(obj.Server);
+%信息分块到达：每个模块一个报文，以空报文结束
+Chunks=cell(1,0);
+while true
+	NumBytes=AsyncStream.Listen(LocalPort);
+	if~NumBytes
+		break;
+	end
+	Chunks{end+1}=AsyncStream.Read(NumBytes);
+end
+Information=CollectStruct(Async_stream_IO.BufferReader([Chunks{:}]),obj.Server.PointerType);
+if obj.State~=Gbec.UID.State_Idle&&Information.RandomSeed==obj.RandomSeed
+	obj.RandomDraws=Information.RandomDraws;
+end
 if obj.HostActions.numEntries%空字典直接取键可能会出错
 	for K=obj.HostActions.keys.'
 		Information.(string(K))=obj.HostActions(K).GetInformation;
 	end
 end
 end
-function Struct=CollectStruct(Server)
+function Struct=CollectStruct(Reader,PointerType)
 import Gbec.UID
-AsyncStream=Server.AsyncStream;
-NumFields=AsyncStream.Read;
+NumFields=Reader.Read;
 Struct=struct;
 for F=1:NumFields
-	Name=AsyncStream.Read;
+	Name=Reader.Read;
 	Name=char(UID(Name));
-	switch UID(AsyncStream.Read)
+	switch UID(Reader.Read)
 		case UID.Type_UID
-			Value=categorical(string(UID(AsyncStream.Read)));
+			Value=categorical(string(UID(Reader.Read)));
 		case UID.Type_Bool
-			Value=logical(AsyncStream.Read);
+			Value=logical(Reader.Read);
 		case UID.Type_UInt8
-			Value=AsyncStream.Read;
+			Value=Reader.Read;
 		case UID.Type_UInt16
-			Value=AsyncStream.Read('uint16');
+			Value=Reader.Read('uint16');
 		case UID.Type_UInt32
-			Value=AsyncStream.Read('uint32');
+			Value=Reader.Read('uint32');
 		case UID.Type_Array
-			Value=CollectArray(Server);
+			Value=CollectArray(Reader,PointerType);
 		case UID.Type_Struct
-			Value=CollectStruct(Server);
+			Value=CollectStruct(Reader,PointerType);
 		case UID.Type_Seconds
-			Value=seconds(AsyncStream.Read(Gbec.Formal.DurationRep));
+			Value=seconds(Reader.Read(Gbec.Formal.DurationRep));
 		case UID.Type_Milliseconds
-			Value=milliseconds(AsyncStream.Read(Gbec.Formal.DurationRep));
+			Value=milliseconds(Reader.Read(Gbec.Formal.DurationRep));
 		case UID.Type_Microseconds
             %MATLAB不支持微秒
-			Value=milliseconds(AsyncStream.Read(Gbec.Formal.DurationRep))/1000;
+			Value=milliseconds(Reader.Read(Gbec.Formal.DurationRep))/1000;
 		case UID.Type_Infinite
 			Value=Inf;
 		case UID.Type_Table
-			Value=CollectTable(Server);
+			Value=CollectTable(Reader,PointerType);
 		case UID.Type_Pointer
-			Value=AsyncStream.Read(Server.PointerType);
+			Value=Reader.Read(PointerType);
 		case UID.Type_Map
-			Value=CollectMap(Server);
+			Value=CollectMap(Reader,PointerType);
 		otherwise
 			Gbec.Exception.Unexpected_response_from_Arduino.Throw;
 	end
 	Struct.(Name(strlength('Field_')+1:end))=Value;
 end
 end
-function Array=CollectArray(Server)
+function Array=CollectArray(Reader,PointerType)
 import Gbec.UID
-AsyncStream=Server.AsyncStream;
-NumElements=AsyncStream.Read;
-switch UID(AsyncStream.Read)
+NumElements=Reader.Read;
+switch UID(Reader.Read)
 	case UID.Type_UID
-		Array=categorical(string(UID(AsyncStream.Read(NumElements,'uint8'))));
+		Array=categorical(string(UID(Reader.Read(NumElements,'uint8'))));
 	case UID.Type_Bool
-		Array=logical(AsyncStream.Read(NumElements,'uint8'));
+		Array=logical(Reader.Read(NumElements,'uint8'));
 	case UID.Type_UInt8
-		Array=AsyncStream.Read(NumElements,'uint8');
+		Array=Reader.Read(NumElements,'uint8');
 	case UID.Type_UInt16
-		Array=AsyncStream.Read(NumElements,'uint16');
+		Array=Reader.Read(NumElements,'uint16');
 	case UID.Type_UInt32
-		Array=AsyncStream.Read(NumElements,'uint32');
+		Array=Reader.Read(NumElements,'uint32');
 	case UID.Type_Seconds
-		Array=seconds(AsyncStream.Read(NumElements,Gbec.Formal.DurationRep));
+		Array=seconds(Reader.Read(NumElements,Gbec.Formal.DurationRep));
 	case UID.Type_Milliseconds
-		Array=milliseconds(AsyncStream.Read(NumElements,Gbec.Formal.DurationRep));
+		Array=milliseconds(Reader.Read(NumElements,Gbec.Formal.DurationRep));
 	case UID.Type_Microseconds
-		Array=milliseconds(AsyncStream.Read(NumElements,Gbec.Formal.DurationRep))/1000;
+		Array=milliseconds(Reader.Read(NumElements,Gbec.Formal.DurationRep))/1000;
 	case UID.Type_Pointer
-		Array=AsyncStream.Read(NumElements,Server.PointerType);
+		Array=Reader.Read(NumElements,PointerType);
 	otherwise
 		Gbec.Exceptions.Unexpected_response_from_Arduino.Throw;
 end
 end
-function Table=CollectTable(Server)
+function Table=CollectTable(Reader,PointerType)
 import Gbec.UID
-AsyncStream=Server.AsyncStream;
-NumRows=AsyncStream.Read;
-NumCols=AsyncStream.Read;
+NumRows=Reader.Read;
+NumCols=Reader.Read;
 Table=table('Size',[NumRows,0]);
 for C=1:NumCols
-	Name=char(UID(AsyncStream.Read));
-	switch UID(AsyncStream.Read)
+	Name=char(UID(Reader.Read));
+	switch UID(Reader.Read)
 		case UID.Type_UID
-			Value=categorical(string(UID(AsyncStream.Read(NumRows))));
+			Value=categorical(string(UID(Reader.Read(NumRows))));
 		case UID.Type_Bool
-			Value=logical(AsyncStream.Read(NumRows));
+			Value=logical(Reader.Read(NumRows));
 		case UID.Type_UInt8
-			Value=AsyncStream.Read(NumRows);
+			Value=Reader.Read(NumRows);
 		case UID.Type_UInt16
-			Value=AsyncStream.Read(NumRows,'uint16');
+			Value=Reader.Read(NumRows,'uint16');
 		case UID.Type_UInt32
-			Value=AsyncStream.Read(NumRows,'uint32');
+			Value=Reader.Read(NumRows,'uint32');
 		case UID.Type_Seconds
-			Value=seconds(AsyncStream.Read(NumRows,Gbec.Formal.DurationRep));
+			Value=seconds(Reader.Read(NumRows,Gbec.Formal.DurationRep));
 		case UID.Type_Milliseconds
-			Value=milliseconds(AsyncStream.Read(NumRows,Gbec.Formal.DurationRep));
+			Value=milliseconds(Reader.Read(NumRows,Gbec.Formal.DurationRep));
 		case UID.Type_Microseconds
-			Value=milliseconds(AsyncStream.Read(NumRows,Gbec.Formal.DurationRep))/1000;
+			Value=milliseconds(Reader.Read(NumRows,Gbec.Formal.DurationRep))/1000;
 		case UID.Type_Pointer
-			Value=AsyncStream.Read(NumRows,Server.PointerType);
+			Value=Reader.Read(NumRows,PointerType);
 		otherwise
 			Gbec.Exceptions.Unexpected_response_from_Arduino.Throw;
 	end
 	Table.(Name(strlength('Column_')+1:end))=Value(:);
 end
 end
-function Map=CollectMap(Server)
+function Map=CollectMap(Reader,PointerType)
 import Gbec.UID
-AsyncStream=Server.AsyncStream;
-NumPairs=AsyncStream.Read;
-switch UID(AsyncStream.Read)
+NumPairs=Reader.Read;
+switch UID(Reader.Read)
 	case UID.Type_UID
-		KeyReader=@(AsyncStream)categorical(string(UID(AsyncStream.Read)));
+		KeyReader=@(Reader)categorical(string(UID(Reader.Read)));
 	case UID.Type_Bool
-		KeyReader=@(AsyncStream)logical(AsyncStream.Read);
+		KeyReader=@(Reader)logical(Reader.Read);
 	case UID.Type_UInt8
-		KeyReader=@(AsyncStream)AsyncStream.Read;
+		KeyReader=@(Reader)Reader.Read;
 	case UID.Type_UInt16
-		KeyReader=@(AsyncStream)AsyncStream.Read('uint16');
+		KeyReader=@(Reader)Reader.Read('uint16');
 	case UID.Type_UInt32
-		KeyReader=@(AsyncStream)AsyncStream.Read('uint32');
+		KeyReader=@(Reader)Reader.Read('uint32');
 	case UID.Type_Seconds
-		KeyReader=@(AsyncStream)seconds(AsyncStream.Read(Gbec.Formal.DurationRep));
+		KeyReader=@(Reader)seconds(Reader.Read(Gbec.Formal.DurationRep));
 	case UID.Type_Milliseconds
-		KeyReader=@(AsyncStream)milliseconds(AsyncStream.Read(Gbec.Formal.DurationRep));
+		KeyReader=@(Reader)milliseconds(Reader.Read(Gbec.Formal.DurationRep));
 	case UID.Type_Microseconds
-		KeyReader=@(AsyncStream)milliseconds(AsyncStream.Read(Gbec.Formal.DurationRep))/1000;
+		KeyReader=@(Reader)milliseconds(Reader.Read(Gbec.Formal.DurationRep))/1000;
 	case UID.Type_Pointer
-		KeyReader=@(AsyncStream)AsyncStream.Read(Server.PointerType);
+		KeyReader=@(Reader)Reader.Read(PointerType);
 	otherwise
 		Gbec.Exceptions.Unexpected_response_from_Arduino.Throw;
 end
-switch UID(AsyncStream.Read)
+switch UID(Reader.Read)
 	case UID.Type_UID
-		ValueReader=@(Server)categorical(string(UID(Server.AsyncStream.Read)));
+		ValueReader=@(Reader,PointerType)categorical(string(UID(Reader.Read)));
 	case UID.Type_Bool
-		ValueReader=@(Server)logical(Server.AsyncStream.Read);
+		ValueReader=@(Reader,PointerType)logical(Reader.Read);
 	case UID.Type_UInt8
-		ValueReader=@(Server)Server.AsyncStream.Read;
+		ValueReader=@(Reader,PointerType)Reader.Read;
 	case UID.Type_UInt16
-		ValueReader=@(Server)Server.AsyncStream.Read('uint16');
+		ValueReader=@(Reader,PointerType)Reader.Read('uint16');
 	case UID.Type_UInt32
-		ValueReader=@(Server)Server.AsyncStream.Read('uint32');
+		ValueReader=@(Reader,PointerType)Reader.Read('uint32');
 	case UID.Type_Seconds
-		ValueReader=@(Server)seconds(Server.AsyncStream.Read(Gbec.Formal.DurationRep));
+		ValueReader=@(Reader,PointerType)seconds(Reader.Read(Gbec.Formal.DurationRep));
 	case UID.Type_Milliseconds
-		ValueReader=@(Server)milliseconds(Server.AsyncStream.Read(Gbec.Formal.DurationRep));
+		ValueReader=@(Reader,PointerType)milliseconds(Reader.Read(Gbec.Formal.DurationRep));
 	case UID.Type_Microseconds
-		ValueReader=@(Server)milliseconds(Server.AsyncStream.Read(Gbec.Formal.DurationRep))/1000;
+		ValueReader=@(Reader,PointerType)milliseconds(Reader.Read(Gbec.Formal.DurationRep))/1000;
 	case UID.Type_Pointer
-		ValueReader=@(Server)Server.AsyncStream.Read(Server.PointerType);
+		ValueReader=@(Reader,PointerType)Reader.Read(PointerType);
 	case UID.Type_Struct
-		ValueReader=@(Server)CollectStruct(Server);		
+		ValueReader=@(Reader,PointerType)CollectStruct(Reader,PointerType);		
 	otherwise
 		Gbec.Exceptions.Unexpected_response_from_Arduino.Throw;
 end
 Map=dictionary;
 for P=1:NumPairs
-	Key=KeyReader(AsyncStream);
-	Map(Key)=ValueReader(Server);
+	Key=KeyReader(Reader);
+	Map(Key)=ValueReader(Reader,PointerType);
 end
 end
 
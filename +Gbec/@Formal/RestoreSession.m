@@ -1,4 +1,5 @@
 %[text] 断线重连失败后，还允许手动恢复会话
+%[text] 如果当前回合内取得过断点，将从断点处继续执行，当前回合不会重做；否则以回合为单位恢复，未完成的回合将从头开始。
 %[text] ## 示例
 %[text] ```matlabCodeExample
 %[text] %假设在BOX3服务器上运行的Formal3进程断线重连失败。手动解决连接问题后，需要先Server对象进行Initialize，然后可以恢复此进程
@@ -10,11 +11,24 @@ if obj.Server.AllProcesses.isConfigured
 	obj.Server.AllProcesses(obj.Pointer)=[];
 end
 AsyncStream=obj.Server.AsyncStream;
-obj.Pointer=typecast(AsyncStream.SyncInvoke(Gbec.UID.PortA_CreateProcess),obj.Server.PointerType);
+obj.Pointer=obj.Server.CreateProcess_;
 obj.Server.AllProcesses(obj.Pointer)=matlab.lang.WeakReference(obj);
+obj.Server.RegisterHandle_(obj.Pointer);
 if obj.State==Gbec.UID.State_Idle
 	return;
 end
+if ~isempty(obj.LastCheckpoint)&&obj.CheckpointTrial==obj.TrialIndex
+	%从断点恢复不发送已完成回合数，设备端的回合计数从0开始。这些计数只用于跳过已完成的回合，而断点已记录了执行位置和各重复的剩余次数，不需要跳过；
+	% 若仍发送，断点之后的同ID回合反而会被误跳过。已完成回合的记录以TrialRecorder为准。
+	obj.EventRecorder.LogEvent(Gbec.UID.Event_ConnectionReset);
+	LocalPort=AsyncStream.AllocatePort;
+	OCU=onCleanup(@()AsyncStream.ReleasePort(LocalPort));
+	TCO=Async_stream_IO.TemporaryCallbackOff(AsyncStream);
+	AsyncStream.BeginSend(Gbec.UID.PortA_RestoreCheckpoint,numel(obj.LastCheckpoint)+2+obj.Server.PointerSize);
+	AsyncStream<=LocalPort<=obj.Pointer<=obj.SessionID<=obj.LastCheckpoint;
+	CheckResult(AsyncStream,LocalPort,obj);
+	return;
+end
 TrialsDone=obj.TrialRecorder.GetTimeTable();
 if ~isempty(TrialsDone)
 	TrialsDone(end,:)=[];
@@ -26,11 +40,19 @@ obj.EventRecorder.LogEvent(Gbec.UID.Event_ConnectionReset);
 LocalPort=AsyncStream.AllocatePort;
 OCU=onCleanup(@()AsyncStream.ReleasePort(LocalPort));
 TCO=Async_stream_IO.TemporaryCallbackOff(AsyncStream);
-AsyncStream.BeginSend(Gbec.UID.PortA_RestoreModule,NumDistinctTrials*3+2+obj.Server.PointerSize);
-AsyncStream<=LocalPort<=obj.Pointer<=obj.SessionID;
+%已知中断时的随机抽取次数才附带随机状态，从中断处接续原来的随机序列；否则设备端将使用新的种子。是否附带由1字节标志显式指示。
+HasRandomState=~isempty(obj.RandomDraws);
+AsyncStream.BeginSend(Gbec.UID.PortA_RestoreModule,NumDistinctTrials*3+3+obj.Server.PointerSize+HasRandomState*8);
+AsyncStream<=LocalPort<=obj.Pointer<=obj.SessionID<=uint8(HasRandomState);
+if HasRandomState
+	AsyncStream<=obj.RandomSeed<=obj.RandomDraws;
+end
 for T=1:NumDistinctTrials
 	AsyncStream<=TrialsDone.Event(T)<=uint16(TrialsDone.GroupCount(T));
 end
+CheckResult(AsyncStream,LocalPort,obj);
+end
+function CheckResult(AsyncStream,LocalPort,obj)
 NumBytes=AsyncStream.Listen(LocalPort);
 if NumBytes==1
 	obj.ThrowResult(AsyncStream.Read);
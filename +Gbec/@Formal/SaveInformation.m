@@ -4,7 +4,9 @@ obj.Server.FeedDogIfActive;
 SP=obj.SavePath;
 if isempty(obj.oTrialwiseSave)
 	[DateTimes,Blocks]=obj.SessionMeta;
-	DateTimes.Metadata={obj.GetInformation};
+	Metadata=obj.GetInformation;
+	Metadata.DeviceEventLog=obj.DeviceEventLog;
+	DateTimes.Metadata={Metadata};
 	Blocks.EventLog=obj.EventLog;
 	Trials=table;
 	Stimulus=obj.TrialRecorder.GetTimeTable;
@@ -50,7 +52,9 @@ else
 	DateTimes=obj.oTrialwiseSave.DateTimes;
 
 	%不能在会话开始前获取信息。也不能在刚开始后获取，因为会话可能是瞬时的，此时会话会在GetInformation之前结束并触发SaveInformation导致错误
-	DateTimes.Metadata={obj.GetInformation};
+	Metadata=obj.GetInformation;
+	Metadata.DeviceEventLog=obj.DeviceEventLog;
+	DateTimes.Metadata={Metadata};
 
 	Blocks.EventLog={obj.EventLog};
 	obj.oTrialwiseSave.Blocks=Blocks;
@@ -32,7 +32,8 @@ AsyncStream=obj.Server.AsyncStream;
 Port=AsyncStream.AllocatePort;
 OCU=onCleanup(@()AsyncStream.ReleasePort(Port));
 TCO=Async_stream_IO.TemporaryCallbackOff(AsyncStream);
-AsyncStream.Send(Async_stream_IO.ArgumentSerialize(Port,obj.Pointer,obj.SessionID),Gbec.UID.PortA_StartModule);
+RandomSeed=randi([0,intmax('uint32')],'uint32');
+AsyncStream.Send(Async_stream_IO.ArgumentSerialize(Port,obj.Pointer,obj.SessionID,RandomSeed),Gbec.UID.PortA_StartModule);
 NumBytes=AsyncStream.Listen(Port);
 switch NumBytes
 	case 0
@@ -56,7 +57,12 @@ end
 obj.CountdownExempt=Gbec.CountdownExempt_(obj.Server);
 obj.EventRecorder.Reset;
 obj.TrialRecorder.Reset;
+obj.DeviceTimes=duration.empty(0,1);
+obj.DeviceEvents=Gbec.UID.empty(0,1);
 obj.TrialIndex=0;
+obj.RandomSeed=RandomSeed;
+obj.RandomDraws=uint32.empty;
+obj.LastCheckpoint=uint8.empty(0,1);
 obj.State=Gbec.UID.State_Running;
 
 if~isempty(obj.oTrialwiseSave)
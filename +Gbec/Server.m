@@ -1,186 +1,407 @@
-classdef Server<handle
-	%控制服务器串口连接
-	properties(SetAccess=protected,Transient)
-		%此属性只能用Initialize方法修改
-		AsyncStream
-	end
-	properties(SetAccess=?Gbec.Process)
-		%所有进程
-		AllProcesses dictionary
-	end
-	properties(SetAccess=immutable)
-		%串口长时间闲置时会自动关闭。
-		SerialCountdown
-	end
-	properties(Access=?Gbec.CountdownExempt_)
-		CountdownExemptLeft=0;
-	end
-	properties(SetAccess=protected,GetAccess=?Gbec.Process)
-		PointerSize
-		PointerType
-	end
-	properties
-		%Server的名称，可以任意设置，在输出消息时作为标识符
-		Name(1,1)string=missing
-	end
-	properties(Access=protected)
-		ConnectionInterruptedListener
-		ConnectionResetListener
-		oSerialTimeout=1
-	end
-	properties(Dependent)
-		%串口读写超时时间，默认为1秒
-		SerialTimeout(1,1)duration
-	end
-	methods(Access=protected)
-		function ProcessForward(obj,Arguments,Method)
-			Process=obj.AllProcesses(typecast(Arguments(1:obj.PointerSize),obj.PointerType)).Handle;
-			if isvalid(Process)
-				if numel(Arguments)>obj.PointerSize
-					Process.(Method)(Arguments(obj.PointerSize+1:end));
-				else
-					Process.(Method)();
-				end
-			end
-		end
-		function ConnectionInterruptedHandler(obj,EventData)
-			Gbec.Exception.Server_connection_interrupted.Throw(sprintf('%s %s',obj.Name,formattedDisplayText(EventData)));
-		end
-		function ConnectionResetHandler(obj)
-			obj.AsyncStream.Listen(Gbec.UID.PortC_ImReady);
-			obj.AsyncStream.AsyncInvoke(Gbec.UID.PortA_RandomSeed,randi([0,intmax('uint32')],'uint32'));
-			if obj.AllProcesses.numEntries
-				arrayfun(@(P)P.Handle.ConnectionReset_(),obj.AllProcesses.values);
-			end
-			obj.AsyncStream.InterruptEnabled=true;
-		end
-	end
-	methods(Access=?Gbec.Process)
-		function FeedDogIfActive(obj)
-			if obj.SerialCountdown.Running=="on"
-				obj.SerialCountdown.stop;
-			end
-			if~obj.CountdownExemptLeft
-				obj.SerialCountdown.start;
-			end
-		end
-	end
-	methods
-		function ReleaseStream(obj)
-			%手动释放关联的流
-			delete(obj.AsyncStream);
-			obj.AllProcesses=dictionary;
-			disp(newline+obj.Name + "：已释放关联的流");
-		end
-		function obj=Server(SerialCountdown)
-			%# 语法
-			% ```
-			% obj = Gbec.Server;
-			% % 创建一个Server对象，使用默认的串口闲置关闭时间
-			%
-			% obj = Gbec.Server(SerialCountdown);
-			% % 创建一个Server对象，使用指定的串口闲置关闭时间
-			% ```
-			%# 输入参数
-			% SerialCountdown(1,1)duration=minutes(4)，串口闲置多长时间后自动关闭
-			arguments
-				SerialCountdown=minutes(4)
-			end
-			disp(['通用行为实验控制器' Gbec.Version().Me ' by 张天夫']);
-			WeakReference=matlab.lang.WeakReference(obj);
-			obj.SerialCountdown=timer(StartDelay=seconds(SerialCountdown),TimerFcn=@(~,~)WeakReference.Handle.ReleaseStream());
-			obj.SerialCountdown.start;
-		end
-		function Initialize(obj,varargin)
-			%初始化异步流服务器
-			%# 语法
-			% ```
-			% obj.Initialize(AsyncStream);
-			% %直接设置底层AsyncStream并初始化
-			%
-			% obj.Initialize(varargin);
-			% %使用指定参数构造一个Async_stream_IO.AsyncSerialStream并初始化
-			% ```
-			%# 输入参数
-			% AsyncStream(1,1)Async_stream_IO.IAsyncStream，自定义底层异步流
-			%See also Async_stream_IO.AsyncSerialStream Async_stream_IO.IAsyncStream
-			obj.FeedDogIfActive;
-			if isa(varargin{1},'Async_stream_IO.IAsyncStream')
-				obj.AsyncStream=varargin{1};
-			else
-				HasOld=~isempty(obj.AsyncStream)&&obj.AsyncStream.isvalid&&obj.AsyncStream.CheckArguments(varargin{:});
-				if HasOld
-					try
-						obj.AsyncStream.Serial.NumBytesAvailable;
-
-						obj.PointerSize=obj.AsyncStream.SyncInvoke(Gbec.UID.PortA_PointerSize);
-						%即使前项通过，后项也可能不通过，需要重置
-					catch ME
-						if any(ME.identifier==["transportlib:transport:invalidConnectionState","Async_stream_IO:Exception:Serial_not_respond_in_time"])
-							HasOld=false;
-						else
-							ME.rethrow;
-						end
-					end
-				end
-				if~HasOld
-					obj.AllProcesses=dictionary;
-					if~isempty(obj.AsyncStream)
-						obj.AsyncStream.delete;
-					end
-					obj.AsyncStream=Async_stream_IO.AsyncSerialStream(varargin{:});
-					obj.AsyncStream.Serial.Timeout=obj.oSerialTimeout;
-					obj.AsyncStream.Listen(Gbec.UID.PortC_ImReady);
-					obj.PointerSize=obj.AsyncStream.SyncInvoke(Gbec.UID.PortA_PointerSize);
-				end
-			end
-			WeakReference=matlab.lang.WeakReference(obj);
-			obj.AsyncStream.BindFunctionToPort(@(Arguments)WeakReference.Handle.ProcessForward(Arguments,"ProcessFinished_"),Gbec.UID.PortC_ProcessFinished);
-			obj.AsyncStream.BindFunctionToPort(@(Arguments)WeakReference.Handle.ProcessForward(Arguments,"Signal_"),Gbec.UID.PortC_Signal);
-			obj.AsyncStream.BindFunctionToPort(@(Arguments)WeakReference.Handle.ProcessForward(Arguments,"TrialStart_"),Gbec.UID.PortC_TrialStart);
-			obj.AsyncStream.BindFunctionToPort(@(Arguments)Gbec.UID(Arguments).Throw,Gbec.UID.PortC_Exception);
-			if ismissing(obj.Name)
-				obj.Name=erase(formattedDisplayText(varargin{1}),newline);
-			end
-			obj.ConnectionInterruptedListener=event.listener(obj.AsyncStream,'ConnectionInterrupted',@(~,EventData)WeakReference.Handle.ConnectionInterruptedHandler(EventData));
-			obj.PointerType="uint"+string(obj.PointerSize*8);
-			obj.AsyncStream.AsyncInvoke(Gbec.UID.PortA_RandomSeed,randi([0,intmax('uint32')],'uint32'));
-			obj.ConnectionResetListener=event.listener(obj.AsyncStream,'ConnectionReset',@(~,~)WeakReference.Handle.ConnectionResetHandler());
-		end
-		function RefreshAllProcesses(obj)
-			%刷新AllProcesses属性
-			%此方法会清除AllProcesses属性并重新获取当前所有进程。通常不需要调用此方法，因为Server会自动维护AllProcesses属性。调用此方法后，所有之前的Process对象不会再收到消息；要继续接收消息，必须重新获取Process对象。
-			Port=obj.AsyncStream.AllocatePort;
-			TCO=Async_stream_IO.TemporaryCallbackOff(obj.AsyncStream);
-			obj.AsyncStream.Send(Port,Gbec.UID.PortA_AllProcesses);
-			NewDict=dictionary;
-			for P=0:int8(obj.PointerSize):int8(obj.AsyncStream.Listen(Port))-1
-				Pointer=obj.AsyncStream.Read(obj.PointerType);
-				if obj.AllProcesses.isKey(Pointer)
-					NewDict(Pointer)=obj.AllProcesses(Pointer);
-				else
-					NewDict(Pointer)=matlab.lang.WeakReference;
-				end
-			end
-			obj.AllProcesses=NewDict;
-			obj.FeedDogIfActive();
-		end
-		function delete(obj)
-			warning off MATLAB:timer:deleterunning;
-			delete(obj.SerialCountdown);
-			delete(obj.ConnectionInterruptedListener);
-		end
-		function ST=get.SerialTimeout(obj)
-			ST=seconds(obj.oSerialTimeout);
-		end
-		function set.SerialTimeout(obj,Value)
-			if isduration(Value)
-				Value=seconds(Value);
-			end
-			obj.oSerialTimeout=Value;
-			if~isempty(obj.AsyncStream)&&obj.AsyncStream.isvalid&&obj.AsyncStream.Serial.isvalid
-				obj.AsyncStream.Serial.Timeout=Value;
-			end
-		end
-	end
-end
\ No newline at end of file
+classdef Server<handle
+	%控制服务器串口连接
+	properties(SetAccess=protected,Transient)
+		%此属性只能用Initialize方法修改
+		AsyncStream
+	end
+	properties(SetAccess=?Gbec.Process)
+		%所有进程
+		AllProcesses dictionary
+	end
+	properties(SetAccess=immutable)
+		%串口长时间闲置时会自动关闭。
+		SerialCountdown
+	end
+	properties(Access=?Gbec.CountdownExempt_)
+		CountdownExemptLeft=0;
+	end
+	properties(SetAccess=protected,GetAccess=?Gbec.Process)
+		PointerSize
+		PointerType
+	end
+	properties
+		%Server的名称，可以任意设置，在输出消息时作为标识符
+		Name(1,1)string=missing
+	end
+	properties(Access=protected)
+		ConnectionInterruptedListener
+		ConnectionResetListener
+		oSerialTimeout=1
+		%展开Arduino端微秒时间戳所需的状态，Arduino复位后必须清空
+		LastDeviceMicros
+		LastUnwrappedMicros
+		LastHostTic
+		%8位进程句柄到进程指针的映射，用于解码紧凑事件报文。Arduino复位后必须清空
+		ProcessHandles=configureDictionary('uint8','uint64')
+	end
+	properties(Dependent)
+		%串口读写超时时间，默认为1秒
+		SerialTimeout(1,1)duration
+	end
+	methods(Access=protected)
+		function ProcessForward(obj,Arguments,Method)
+			Process=obj.AllProcesses(typecast(Arguments(1:obj.PointerSize),obj.PointerType)).Handle;
+			if isvalid(Process)
+				if numel(Arguments)>obj.PointerSize
+					Process.(Method)(Arguments(obj.PointerSize+1:end));
+				else
+					Process.(Method)();
+				end
+			end
+		end
+		function TimedForward(obj,Arguments,Method)
+			%Arguments由进程指针、UID和uint32微秒时间戳组成。即使进程已失效，也要展开时间戳以保持时钟连续。
+			PointerSize=obj.PointerSize;
+			Time=obj.DeviceTime(typecast(Arguments(PointerSize+2:PointerSize+5),'uint32'));
+			Process=obj.AllProcesses(typecast(Arguments(1:PointerSize),obj.PointerType)).Handle;
+			if isvalid(Process)
+				Process.(Method)(Arguments(PointerSize+1),Time);
+			end
+		end
+		function BatchListener(obj,MessageSize)
+			%紧凑批量事件报文不带返回端口号，由若干个紧密排列的{uint8进程句柄,UID,uint32微秒时间戳}记录组成，逐个转发给进程的Signal_
+			Records=reshape(obj.AsyncStream.Read(MessageSize),6,[]);
+			for R=1:width(Records)
+				Time=obj.DeviceTime(typecast(Records(3:6,R),'uint32'));
+				if obj.ProcessHandles.isKey(Records(1,R))
+					Pointer=cast(obj.ProcessHandles(Records(1,R)),obj.PointerType);
+					if obj.AllProcesses.isConfigured&&obj.AllProcesses.isKey(Pointer)
+						Process=obj.AllProcesses(Pointer).Handle;
+						if isvalid(Process)
+							Process.Signal_(Records(2,R),Time);
+						end
+					end
+				end
+			end
+		end
+		function Time=DeviceTime(obj,Micros)
+			%将Arduino端uint32微秒时间戳展开为自Arduino启动以来的时间
+			%micros()约71.6分钟回绕一次。两次时间戳之间的回绕次数由主机时钟经过的时间估计，因此即使长时间没有事件也能正确展开。引脚事件的时间戳可能略早于此前已
+			% 收到的计时器事件，因此差值按有符号数处理。
+			Micros=double(Micros);
+			if isempty(obj.LastDeviceMicros)
+				Unwrapped=Micros;
+			else
+				Delta=mod(Micros-obj.LastDeviceMicros+2^31,2^32)-2^31;
+				Elapsed=toc(obj.LastHostTic)*1e6;
+				Unwrapped=obj.LastUnwrappedMicros+Delta+round((Elapsed-Delta)/2^32)*2^32;
+			end
+			obj.LastDeviceMicros=Micros;
+			obj.LastUnwrappedMicros=Unwrapped;
+			obj.LastHostTic=tic;
+			Time=seconds(Unwrapped/1e6);
+		end
+		function ConnectionInterruptedHandler(obj,EventData)
+			Gbec.Exception.Server_connection_interrupted.Throw(sprintf('%s %s',obj.Name,formattedDisplayText(EventData)));
+		end
+		function ConnectionResetHandler(obj)
+			obj.LastDeviceMicros=[];
+			obj.ProcessHandles=configureDictionary('uint8','uint64');
+			obj.AsyncStream.Listen(Gbec.UID.PortC_ImReady);
+			obj.AsyncStream.AsyncInvoke(Gbec.UID.PortA_RandomSeed,randi([0,intmax('uint32')],'uint32'));
+			if obj.AllProcesses.numEntries
+				arrayfun(@(P)P.Handle.ConnectionReset_(),obj.AllProcesses.values);
+			end
+			obj.AsyncStream.InterruptEnabled=true;
+		end
+	end
+	methods(Access=?Gbec.Process)
+		function Pointer=CreateProcess_(obj)
+			%在Arduino上创建进程并返回其指针。Arduino的8位进程句柄用尽时拒绝创建，返回空指针
+			Pointer=typecast(obj.AsyncStream.SyncInvoke(Gbec.UID.PortA_CreateProcess),obj.PointerType);
+			if~Pointer
+				Gbec.Exception.Arduino_ran_out_of_process_handles.Throw;
+			end
+		end
+		function RegisterHandle_(obj,Pointer)
+			%查询进程的8位句柄并登记，此后该进程才能收到紧凑事件报文
+			Handle=obj.AsyncStream.SyncInvoke(Gbec.UID.PortA_ProcessHandle,Pointer);
+			if Handle<255
+				obj.ProcessHandles(Handle)=uint64(Pointer);
+			end
+		end
+		function FeedDogIfActive(obj)
+			if obj.SerialCountdown.Running=="on"
+				obj.SerialCountdown.stop;
+			end
+			if~obj.CountdownExemptLeft
+				obj.SerialCountdown.start;
+			end
+		end
+	end
+	methods
+		function ReleaseStream(obj)
+			%手动释放关联的流
+			delete(obj.AsyncStream);
+			obj.AllProcesses=dictionary;
+			disp(newline+obj.Name + "：已释放关联的流");
+		end
+		function obj=Server(SerialCountdown)
+			%# 语法
+			% ```
+			% obj = Gbec.Server;
+			% % 创建一个Server对象，使用默认的串口闲置关闭时间
+			%
+			% obj = Gbec.Server(SerialCountdown);
+			% % 创建一个Server对象，使用指定的串口闲置关闭时间
+			% ```
+			%# 输入参数
+			% SerialCountdown(1,1)duration=minutes(4)，串口闲置多长时间后自动关闭
+			arguments
+				SerialCountdown=minutes(4)
+			end
+			disp(['通用行为实验控制器' Gbec.Version().Me ' by 张天夫']);
+			WeakReference=matlab.lang.WeakReference(obj);
+			obj.SerialCountdown=timer(StartDelay=seconds(SerialCountdown),TimerFcn=@(~,~)WeakReference.Handle.ReleaseStream());
+			obj.SerialCountdown.start;
+		end
+		function Initialize(obj,varargin)
+			%初始化异步流服务器
+			%# 语法
+			% ```
+			% obj.Initialize(AsyncStream);
+			% %直接设置底层AsyncStream并初始化
+			%
+			% obj.Initialize(varargin);
+			% %使用指定参数构造一个Async_stream_IO.AsyncSerialStream并初始化
+			% ```
+			%# 输入参数
+			% AsyncStream(1,1)Async_stream_IO.IAsyncStream，自定义底层异步流
+			%See also Async_stream_IO.AsyncSerialStream Async_stream_IO.IAsyncStream
+			obj.FeedDogIfActive;
+			if isa(varargin{1},'Async_stream_IO.IAsyncStream')
+				obj.AsyncStream=varargin{1};
+				obj.LastDeviceMicros=[];
+				obj.ProcessHandles=configureDictionary('uint8','uint64');
+			else
+				HasOld=~isempty(obj.AsyncStream)&&obj.AsyncStream.isvalid&&obj.AsyncStream.CheckArguments(varargin{:});
+				if HasOld
+					try
+						obj.AsyncStream.Serial.NumBytesAvailable;
+
+						obj.PointerSize=obj.AsyncStream.SyncInvoke(Gbec.UID.PortA_PointerSize);
+						%即使前项通过，后项也可能不通过，需要重置
+					catch ME
+						if any(ME.identifier==["transportlib:transport:invalidConnectionState","Async_stream_IO:Exception:Serial_not_respond_in_time"])
+							HasOld=false;
+						else
+							ME.rethrow;
+						end
+					end
+				end
+				if~HasOld
+					obj.AllProcesses=dictionary;
+					obj.LastDeviceMicros=[];
+					obj.ProcessHandles=configureDictionary('uint8','uint64');
+					if~isempty(obj.AsyncStream)
+						obj.AsyncStream.delete;
+					end
+					obj.AsyncStream=Async_stream_IO.AsyncSerialStream(varargin{:});
+					obj.AsyncStream.Serial.Timeout=obj.oSerialTimeout;
+					obj.AsyncStream.Listen(Gbec.UID.PortC_ImReady);
+					obj.PointerSize=obj.AsyncStream.SyncInvoke(Gbec.UID.PortA_PointerSize);
+				end
+			end
+			WeakReference=matlab.lang.WeakReference(obj);
+			obj.AsyncStream.BindFunctionToPort(@(Arguments)WeakReference.Handle.ProcessForward(Arguments,"ProcessFinished_"),Gbec.UID.PortC_ProcessFinished);
+			obj.AsyncStream.BindFunctionToPort(@(Arguments)WeakReference.Handle.ProcessForward(Arguments,"Signal_"),Gbec.UID.PortC_Signal);
+			obj.AsyncStream.Listen(@(MessageSize)WeakReference.Handle.BatchListener(MessageSize),Gbec.UID.PortC_SignalBatch);
+			obj.AsyncStream.BindFunctionToPort(@(Arguments)WeakReference.Handle.TimedForward(Arguments,"TrialStart_"),Gbec.UID.PortC_TrialStart);
+			obj.AsyncStream.BindFunctionToPort(@(Arguments)Gbec.UID(Arguments).Throw,Gbec.UID.PortC_Exception);
+			if ismissing(obj.Name)
+				obj.Name=erase(formattedDisplayText(varargin{1}),newline);
+			end
+			obj.ConnectionInterruptedListener=event.listener(obj.AsyncStream,'ConnectionInterrupted',@(~,EventData)WeakReference.Handle.ConnectionInterruptedHandler(EventData));
+			obj.PointerType="uint"+string(obj.PointerSize*8);
+			obj.AsyncStream.AsyncInvoke(Gbec.UID.PortA_RandomSeed,randi([0,intmax('uint32')],'uint32'));
+			obj.ConnectionResetListener=event.listener(obj.AsyncStream,'ConnectionReset',@(~,~)WeakReference.Handle.ConnectionResetHandler());
+		end
+		function RefreshAllProcesses(obj)
+			%刷新AllProcesses属性
+			%此方法会清除AllProcesses属性并重新获取当前所有进程。通常不需要调用此方法，因为Server会自动维护AllProcesses属性。调用此方法后，所有之前的Process对象不会再收到消息；要继续接收消息，必须重新获取Process对象。
+			Port=obj.AsyncStream.AllocatePort;
+			TCO=Async_stream_IO.TemporaryCallbackOff(obj.AsyncStream);
+			obj.AsyncStream.Send(Port,Gbec.UID.PortA_AllProcesses);
+			NewDict=dictionary;
+			for P=0:int8(obj.PointerSize):int8(obj.AsyncStream.Listen(Port))-1
+				Pointer=obj.AsyncStream.Read(obj.PointerType);
+				if obj.AllProcesses.isKey(Pointer)
+					NewDict(Pointer)=obj.AllProcesses(Pointer);
+				else
+					NewDict(Pointer)=matlab.lang.WeakReference;
+				end
+			end
+			obj.AllProcesses=NewDict;
+			obj.FeedDogIfActive();
+		end
+		function SetBaudRate(obj,BaudRate,Timeout)
+			%与Arduino协商切换串口波特率
+			%Arduino应答后双方切换到新波特率，PC端随即以新波特率确认。如果未能在Timeout内确认，双方都将自动回退到原波特率。断线重连后将回到初始化时指定的波特率，
+			% 需要重新协商。
+			%# 语法
+			% ```
+			% obj.SetBaudRate(BaudRate);
+			% %切换到指定波特率，使用默认确认时限
+			%
+			% obj.SetBaudRate(BaudRate,Timeout);
+			% %额外指定确认时限
+			% ```
+			%# 输入参数
+			% BaudRate(1,1)uint32，新波特率。AVR开发板在16MHz时钟下，1000000和2000000是误差最小的高速波特率。时钟分频误差超过2.5%的波特率（例如16MHz下的230400）
+			% 将被Arduino拒绝，抛出Exception_InvalidBaudRate，不会切换。
+			% Timeout(1,1)duration=seconds(1)，Arduino等待PC端以新波特率确认的时限
+			arguments
+				obj
+				BaudRate(1,1)uint32
+				Timeout(1,1)duration=seconds(1)
+			end
+			obj.FeedDogIfActive;
+			AsyncStream=obj.AsyncStream;
+			Serial=AsyncStream.Serial;
+			OldBaudRate=Serial.BaudRate;
+			Result=Gbec.UID(AsyncStream.SyncInvoke(Gbec.UID.PortA_SetBaudRate,BaudRate,uint16(milliseconds(Timeout))));
+			if Result~=Gbec.UID.Exception_Success
+				Result.Throw;
+			end
+			%Arduino在下一个loop中切换，给它一点时间
+			pause(0.05);
+			if TryBaudRate(AsyncStream,BaudRate,Timeout/2)
+				return;
+			end
+			%确认失败。等待Arduino超时回退后，在原波特率上检查；如果Arduino实际已收到确认，则它仍停留在新波特率
+			pause(seconds(Timeout));
+			if TryBaudRate(AsyncStream,OldBaudRate,Timeout/2)
+				Gbec.Exception.Serial_handshake_failed.Throw(sprintf('%s 无法以波特率%u通信，已回退到%u',obj.Name,BaudRate,OldBaudRate));
+			elseif~TryBaudRate(AsyncStream,BaudRate,Timeout/2)
+				Gbec.Exception.Serial_handshake_failed.Throw(sprintf('%s 切换波特率后失去连接',obj.Name));
+			end
+		end
+		function S=StreamStatistics(obj)
+			%获取Arduino端发送缓冲区的运行统计
+			%# 语法
+			% ```
+			% S=obj.StreamStatistics;
+			% ```
+			%# 返回值
+			% S(1,1)struct，包含以下字段：
+			% - BufferCapacity(1,1)uint16，发送缓冲区的字节容量
+			% - HighWaterMark(1,1)uint16，自Arduino启动以来发送缓冲区占用的最大字节数
+			% - DroppedFrames(1,1)uint32，因发送缓冲区已满而在中断中丢弃的报文数
+			% - DroppedEventBatches(1,1)uint16，其中丢弃的合并事件批数。每批最多含MaxEvents个事件，见SetEventBatch
+			obj.FeedDogIfActive;
+			Return=obj.AsyncStream.SyncInvoke(Gbec.UID.PortA_StreamStatistics);
+			S.BufferCapacity=typecast(Return(1:2),'uint16');
+			S.HighWaterMark=typecast(Return(3:4),'uint16');
+			S.DroppedFrames=typecast(Return(5:8),'uint32');
+			S.DroppedEventBatches=typecast(Return(9:10),'uint16');
+		end
+		function SetEventBatch(obj,Window,MaxEvents)
+			%设置Arduino端事件合并发送的参数
+			%Arduino将短时间内产生的多个事件合并为一个报文发送，以减少串口帧头开销。批中最早的事件等待超过Window，或事件数达到MaxEvents时，整批发出。回合开始和进程结束前总
+			% 是先发出已合并的事件，因此事件顺序不受影响。默认Window为10毫秒，MaxEvents为Arduino端的批容量。
+			%# 语法
+			% ```
+			% obj.SetEventBatch(Window,MaxEvents);
+			% ```
+			%# 输入参数
+			% Window(1,1)duration，合并时间窗口。设为0将不合并，每个事件立即发出。
+			% MaxEvents(1,1)uint8，每批最多合并的事件数，不能超过Arduino端GBEC_EVENT_BATCH_CAPACITY
+			arguments
+				obj
+				Window(1,1)duration
+				MaxEvents(1,1)uint8
+			end
+			obj.FeedDogIfActive;
+			Result=Gbec.UID(obj.AsyncStream.SyncInvoke(Gbec.UID.PortA_SetEventBatch,uint16(milliseconds(Window)),MaxEvents));
+			if Result~=Gbec.UID.Exception_Success
+				Result.Throw;
+			end
+		end
+		function Count=AllocationCount(obj)
+			%获取Arduino端自启动以来的堆分配次数
+			%仅当Arduino程序以GBEC_COUNT_ALLOCATIONS宏构建时可用，用于验证命令路径不分配堆内存：在两次调用之间执行暂停、继续等命令，比较前后计数即可。
+			%# 语法
+			% ```
+			% Count=obj.AllocationCount;
+			% ```
+			%# 返回值
+			% Count(1,1)uint32，全局operator new的调用次数
+			obj.FeedDogIfActive;
+			Count=typecast(obj.AsyncStream.SyncInvoke(Gbec.UID.PortA_AllocationCount),'uint32');
+			if Count==intmax('uint32')
+				Gbec.Exception.Instrumentation_not_built.Throw('Arduino程序未以GBEC_COUNT_ALLOCATIONS宏构建');
+			end
+		end
+		function S=TimerStatistics(obj)
+			%获取Arduino端计时器中断和续延队列的运行统计
+			%中断耗时仅当Arduino程序以GBEC_COUNT_ALLOCATIONS宏构建时可用；续延队列仅当以GBEC_DEFER_TIMER_CONTINUATIONS宏构建时可用。不可用的字段为空。
+			%# 语法
+			% ```
+			% S=obj.TimerStatistics;
+			% ```
+			%# 返回值
+			% S(1,1)struct，包含以下字段：
+			% - IsrCount(1,1)uint32，自Arduino启动以来计时器中断处理的次数
+			% - IsrMeanTime(1,1)duration，计时器中断处理的平均耗时
+			% - IsrMaxTime(1,1)duration，计时器中断处理的最大耗时
+			% - QueueCapacity(1,1)uint8，每级续延队列的容量
+			% - QueueHighWater(1,1)uint8，自Arduino启动以来单级续延队列的最大长度
+			% - QueueOverflows(1,1)uint16，因续延队列已满而在中断中就地执行的续延数
+			obj.FeedDogIfActive;
+			Return=obj.AsyncStream.SyncInvoke(Gbec.UID.PortA_TimerStatistics);
+			S.IsrCount=typecast(Return(1:4),'uint32');
+			if S.IsrCount==intmax('uint32')
+				S.IsrCount=[];
+				S.IsrMeanTime=[];
+				S.IsrMaxTime=[];
+			else
+				S.IsrMeanTime=milliseconds(double(typecast(Return(5:8),'uint32'))/max(double(S.IsrCount),1)/1000);
+				S.IsrMaxTime=milliseconds(double(typecast(Return(9:12),'uint32'))/1000);
+			end
+			S.QueueCapacity=Return(13);
+			if S.QueueCapacity
+				S.QueueHighWater=Return(14);
+				S.QueueOverflows=typecast(Return(15:16),'uint16');
+			else
+				S.QueueCapacity=[];
+				S.QueueHighWater=[];
+				S.QueueOverflows=[];
+			end
+		end
+		function delete(obj)
+			warning off MATLAB:timer:deleterunning;
+			delete(obj.SerialCountdown);
+			delete(obj.ConnectionInterruptedListener);
+		end
+		function ST=get.SerialTimeout(obj)
+			ST=seconds(obj.oSerialTimeout);
+		end
+		function set.SerialTimeout(obj,Value)
+			if isduration(Value)
+				Value=seconds(Value);
+			end
+			obj.oSerialTimeout=Value;
+			if~isempty(obj.AsyncStream)&&obj.AsyncStream.isvalid&&obj.AsyncStream.Serial.isvalid
+				obj.AsyncStream.Serial.Timeout=Value;
+			end
+		end
+	end
+end
+function Success=TryBaudRate(AsyncStream,BaudRate,Timeout)
+%切换本地串口到指定波特率，并请求Arduino确认。只有Arduino回报的波特率与本地一致才算成功。
+Serial=AsyncStream.Serial;
+Serial.BaudRate=BaudRate;
+flush(Serial);
+OldTimeout=Serial.Timeout;
+Serial.Timeout=seconds(Timeout);
+RestoreTimeout=onCleanup(@()set(Serial,'Timeout',OldTimeout));
+try
+	Success=typecast(AsyncStream.SyncInvoke(Gbec.UID.PortA_ConfirmBaudRate),'uint32')==BaudRate;
+catch ME
+	if ME.identifier=="Async_stream_IO:Exception:Serial_not_respond_in_time"
+		Success=false;
+	else
+		ME.rethrow;
+	end
+end
+end
@@ -2,7 +2,7 @@ function V=Version
 V.Me='v8.2.0';
 V.MatlabExtension='20.1.0';
 V.MATLAB='R2025a';
-V.Deploy=13;
+V.Deploy=14;
 persistent NewVersion
 if isempty(NewVersion)
 	NewVersion=TextAnalytics.CheckUpdateFromGitHub('https://github.com/ShanghaitechGuanjisongLab/Generic-Behavioural-Experimental-Control/releases','通用行为实验控制',V.Me);
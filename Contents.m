@@ -1,2 +1,2 @@
-% 通用行为实验控制
+% 通用行为实验控制
 % Version 8.2.0 (R2026a) 8-Jun-2026
\ No newline at end of file
@@ -1,98 +1,227 @@
-#include "Async_stream_IO.hpp"
-#include <queue>
-#include <unordered_map>
-#include <set>
-namespace Async_stream_IO {
-
-// 调用这些方法前必须禁用中断
-
-Port AsyncStream::_AllocatePort() const {
-	static Port P = 0;
-	while (_Listeners.contains(P))
-		P = (P + 1) % 255;
-	return P;
-}
-Port AsyncStream::AllocatePort() {
-	InterruptGuard const _;
-	Port const P = _AllocatePort();
-	_Listeners[P] = [this](MessageSize MS) {
-		Skip(MS);
-	};
-	return P;
-}
-
-// 用于查找一个有效消息的起始
-constexpr uint8_t MagicByte = 0x5A;
-
-template<typename T>
-inline std::enable_if_t<(sizeof(T) > 1), std::vector<byte>> &operator<<(std::vector<byte> &S, T const &Value) {
-	S.insert(S.end(), reinterpret_cast<const char *>(&Value), reinterpret_cast<const char *>(&Value + 1));
-	return S;
-}
-template<typename T>
-inline std::enable_if_t<sizeof(T) == 1, std::vector<byte>> &operator<<(std::vector<byte> &S, T const &Value) {
-	S.push_back(Value);
-	return S;
-}
-void AsyncStream::Send(const void *Message, MessageSize Length, Port ToPort) {
-
-	InterruptGuard const _;
-	(InputBuffer << MagicByte << ToPort << Length).insert(InputBuffer.end(), reinterpret_cast<const char *>(Message), reinterpret_cast<const char *>(Message) + Length);
-}
-InterruptGuard AsyncStream::BeginSend(MessageSize Length, Port ToPort) {
-	InterruptGuard Token;
-	(InputBuffer << MagicByte << ToPort << Length);
-	return Token;
-}
-
-void AsyncStream::PortForward(AsioHeader Header) {
-	noInterrupts();
-	auto PortListener = _Listeners.find(Header.ToPort);
-	if (PortListener == _Listeners.end()) {
-		// 消息指向未监听的端口，丢弃
-		interrupts();
-		Skip(Header.Length);
-		return;
-	}
-	// 先将回调函数取回本地，这样回调函数可以安全释放端口
-	std::move_only_function<void(MessageSize) const> L = std::move(PortListener->second);
-	PortListener->second = nullptr;
-	interrupts();
-	L(Header.Length);
-	noInterrupts();
-
-	// 检查回调函数是否释放或重新分配了端口。如果释放了，不能满足条件1；如果重新分配了，不能满足条件2。只有未发生这两种情况，才能满足条件1和2，才能将取回本地的回调方法重新放回容器。
-	if ((PortListener = _Listeners.find(Header.ToPort)) != _Listeners.end() && PortListener->second == nullptr)
-		PortListener->second = std::move(L);
-	interrupts();
-}
-void AsyncStream::Flush() {
-	noInterrupts();
-	std::swap(InputBuffer, OutputBuffer);
-	interrupts();
-	BaseStream.write(OutputBuffer.data(), OutputBuffer.size());
-	OutputBuffer.clear();
-}
-void AsyncStream::ExecuteTransactionsInQueue() {
-	Flush();
-	while (BaseStream.available())
-		if (BaseStream.read() == MagicByte)
-			PortForward(Read<AsioHeader>());
-}
-MessageSize AsyncStream::Listen(Port FromPort) {
-	Flush();
-	for (;;) {
-		if (Read<decltype(MagicByte)>() == MagicByte) {
-			AsioHeader const Header = Read<AsioHeader>();
-			if (Header.ToPort == FromPort)
-				return Header.Length;
-			PortForward(Header);
-		}
-	}
-}
-void AsyncStream::Skip(MessageSize Length) const {
-	while (Length)
-		if (BaseStream.read() != -1)
-			--Length;
-}
+#include "Async_stream_IO.hpp"
+#include <queue>
+#include <set>
+namespace Async_stream_IO {
+
+// 调用这些方法前必须禁用中断
+
+Port AsyncStream::_AllocatePort() {
+	if (_SlotBitmap.FindFirstZero() == ASYNC_STREAM_IO_LISTENER_SLOTS)
+		return 255;
+	uint16_t P = _PortBitmap.FindFirstZero(_NextPort);
+	if (P == 255 && (P = _PortBitmap.FindFirstZero(0, _NextPort)) == _NextPort)
+		return 255;
+	_NextPort = (P + 1) % 255;
+	return P;
+}
+std::move_only_function<void(MessageSize) const> *AsyncStream::_ListenerSlot(Port P) {
+	if (_PortBitmap.Test(P))
+		return _Listeners + _PortSlots[P];
+	uint8_t const Slot = _SlotBitmap.FindFirstZero();
+	if (Slot == ASYNC_STREAM_IO_LISTENER_SLOTS)
+		return nullptr;
+	_SlotBitmap.Set(Slot);
+	_PortBitmap.Set(P);
+	_PortSlots[P] = Slot;
+	return _Listeners + Slot;
+}
+Port AsyncStream::AllocatePort() {
+	InterruptGuard const _;
+	Port const P = _AllocatePort();
+	if (P < 255)
+		*_ListenerSlot(P) = [this](MessageSize MS) {
+			Skip(MS);
+		};
+	return P;
+}
+bool AsyncStream::ReleasePort(Port P) {
+	InterruptGuard const _;
+	if (P == 255 || !_PortBitmap.Test(P))
+		return false;
+	uint8_t const Slot = _PortSlots[P];
+	_Listeners[Slot] = nullptr;
+	_SlotBitmap.Reset(Slot);
+	_PortBitmap.Reset(P);
+	return true;
+}
+
+// 用于查找一个有效消息的起始
+constexpr uint8_t MagicByte = 0x5A;
+// 紧凑报文的起始，其后是1字节端口号和1字节长度。只用于发送，接收时只识别MagicByte
+constexpr uint8_t CompactMagicByte = 0xA5;
+
+void AsyncStream::Send(const void *Message, MessageSize Length, Port ToPort) {
+	SendSession const _ = BeginSend(Length, ToPort);
+	Write(reinterpret_cast<byte const *>(Message), Length);
+}
+AsyncStream::SendSession AsyncStream::BeginSend(MessageSize Length, Port ToPort) {
+	SendSession Session = _BeginFrame(sizeof(MagicByte) + sizeof(AsioHeader) + Length);
+	*this << MagicByte << AsioHeader{ ToPort, Length };
+	return Session;
+}
+AsyncStream::SendSession AsyncStream::BeginCompactSend(uint8_t Length, Port ToPort) {
+	SendSession Session = _BeginFrame(sizeof(CompactMagicByte) + sizeof(Port) + sizeof(Length) + Length);
+	*this << CompactMagicByte << ToPort << Length;
+	return Session;
+}
+AsyncStream::SendSession AsyncStream::_BeginFrame(MessageSize FrameLength) {
+	bool const ThreadContext = InterruptGuard::ThreadContext();
+	SendSession Session(*this);
+	if (OutputBuffer.Reserve(FrameLength))
+		SendMode = _SendMode::Buffer;
+	else if (!ThreadContext) {
+		// 中断处理函数中不能等待串口，只能丢弃
+		SendMode = _SendMode::Discard;
+		++DroppedFrames;
+		return Session;
+	} else if (FrameLength > ASYNC_STREAM_IO_BUFFER_SIZE) {
+		interrupts();
+		Flush();
+		// 直写期间中断保持启用，此间发生的中断仍可向缓冲区发送报文，它们会在会话结束时恢复SendMode
+		SendMode = _SendMode::Direct;
+	} else
+		do {
+			interrupts();
+			Flush();
+			noInterrupts();
+		} while (!OutputBuffer.Reserve(FrameLength));
+	return Session;
+}
+void AsyncStream::Write(byte const *Data, MessageSize Length) {
+	switch (SendMode) {
+		case _SendMode::Buffer:
+			OutputBuffer.Put(Data, Length);
+			break;
+		case _SendMode::Direct:
+			BaseStream.write(Data, Length);
+			break;
+		case _SendMode::Discard:
+			break;
+	}
+}
+void AsyncStream::WriteFlash(byte const *Data, MessageSize Length) {
+	while (Length--)
+		*this << static_cast<byte>(pgm_read_byte(Data++));
+}
+
+void AsyncStream::PortForward(AsioHeader Header) {
+	noInterrupts();
+	if (Header.ToPort == 255 || !_PortBitmap.Test(Header.ToPort)) {
+		// 消息指向未监听的端口，丢弃
+		interrupts();
+		Skip(Header.Length);
+		return;
+	}
+	// 先将回调函数取回本地，这样回调函数可以安全释放端口
+	std::move_only_function<void(MessageSize) const> &Slot = _Listeners[_PortSlots[Header.ToPort]];
+	std::move_only_function<void(MessageSize) const> L = std::move(Slot);
+	Slot = nullptr;
+	interrupts();
+	L(Header.Length);
+	noInterrupts();
+
+	// 检查回调函数是否释放或重新分配了端口。如果释放了，不能满足条件1；如果重新分配了，不能满足条件2。只有未发生这两种情况，才能满足条件1和2，才能将取回本地的回调方法重新放回容器。回调期间槽位可能被释放后转给其它端口，因此必须重新查索引。
+	if (_PortBitmap.Test(Header.ToPort) && _Listeners[_PortSlots[Header.ToPort]] == nullptr)
+		_Listeners[_PortSlots[Header.ToPort]] = std::move(L);
+	interrupts();
+}
+MessageSize AsyncStream::_WriteOut(MessageSize Budget) {
+	byte const *Bytes;
+	noInterrupts();
+	MessageSize const Length = std::min(OutputBuffer.Peek(Bytes), Budget);
+	interrupts();
+	if (Length) {
+		// 消费者只有本方法，已写入的字节在Consume之前不会被生产者覆盖，因此可以在启用中断时读取
+		BaseStream.write(Bytes, Length);
+		noInterrupts();
+		OutputBuffer.Consume(Length);
+		interrupts();
+	}
+	return Length;
+}
+void AsyncStream::Flush() {
+	while (_WriteOut(std::numeric_limits<MessageSize>::max()))
+		;
+}
+void AsyncStream::FlushAvailable() {
+	int Budget = BaseStream.availableForWrite();
+	while (Budget > 0) {
+		MessageSize const Written = _WriteOut(Budget);
+		if (!Written)
+			return;
+		Budget -= Written;
+	}
+}
+void AsyncStream::ExecuteTransactionsInQueue() {
+	if (BudgetedFlush)
+		FlushAvailable();
+	else
+		Flush();
+	while (BaseStream.available())
+		if (BaseStream.read() == MagicByte)
+			PortForward(Read<AsioHeader>());
+}
+MessageSize AsyncStream::Listen(Port FromPort) {
+	Flush();
+	for (;;) {
+		if (Read<decltype(MagicByte)>() != MagicByte)
+			continue;
+		AsioHeader const Header = Read<AsioHeader>();
+		if (Header.ToPort == FromPort)
+			return Header.Length;
+		PortForward(Header);
+	}
+}
+Exception AsyncStream::Listen(Port FromPort, Timeout Limit, MessageSize &Length) {
+	Flush();
+	uint32_t const Start = millis();
+	for (;;) {
+		while (BaseStream.available()) {
+			if (BaseStream.read() != MagicByte)
+				continue;
+			if (!_WaitAvailable(sizeof(AsioHeader), Start, Limit.Milliseconds))
+				return Exception::Serial_not_respond_in_time;
+			AsioHeader const Header = Read<AsioHeader>();
+			if (Header.ToPort == FromPort) {
+				Length = Header.Length;
+				return Exception::Success;
+			}
+			noInterrupts();
+			bool const Listened = Header.ToPort != 255 && _PortBitmap.Test(Header.ToPort);
+			interrupts();
+			if (Listened)
+				PortForward(Header);
+			else if (!_SkipWithin(Header.Length, Start, Limit.Milliseconds))
+				return Exception::Serial_not_respond_in_time;
+		}
+		if (millis() - Start >= Limit.Milliseconds)
+			return Exception::Serial_not_respond_in_time;
+		if (WaitingCallback)
+			WaitingCallback();
+	}
+}
+bool AsyncStream::_WaitAvailable(int Bytes, uint32_t Start, uint32_t Milliseconds) {
+	while (BaseStream.available() < Bytes) {
+		if (millis() - Start >= Milliseconds)
+			return false;
+		if (WaitingCallback)
+			WaitingCallback();
+	}
+	return true;
+}
+bool AsyncStream::_SkipWithin(MessageSize Length, uint32_t Start, uint32_t Milliseconds) {
+	while (Length)
+		if (BaseStream.read() != -1)
+			--Length;
+		else if (millis() - Start >= Milliseconds)
+			return false;
+		else if (WaitingCallback)
+			WaitingCallback();
+	return true;
+}
+void AsyncStream::Skip(MessageSize Length) const {
+	while (Length)
+		if (BaseStream.read() != -1)
+			--Length;
+}
 }
\ No newline at end of file
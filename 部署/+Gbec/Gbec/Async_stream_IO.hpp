@@ -1,425 +1,692 @@
-#pragma once
-#include <Cpp_Standard_Library.h>
-#include <memory>
-#include <unordered_map>
-#include <vector>
-#include <limits>
-#include <Arduino.h>
-#undef min
-#undef max
-namespace Async_stream_IO {
-using MessageSize = uint16_t;
-using Port = uint8_t;
-enum class Exception : uint8_t {
-	Success,
-	Argument_message_incomplete,
-	Corrupted_object_received,
-	Function_runtime_error,
-	Message_received_on_allocated_port,
-	Unlistened_port_received_message,
-	Remote_function_have_no_return,
-	Serial_not_respond_in_time,
-};
-// 构造此临时对象以禁用中断并保存状态。当前作用域退出时，此对象析构并恢复之前的中断状态。
-struct InterruptGuard {
-	InterruptGuard() {
-		noInterrupts();
-	}
-	InterruptGuard(InterruptGuard const &) = delete;
-	InterruptGuard(InterruptGuard &&Other) noexcept
-	  : InterruptEnabled(Other.InterruptEnabled), ShouldDestroy(Other.ShouldDestroy) {
-		Other.ShouldDestroy = false;
-	}
-	~InterruptGuard() {
-		if (InterruptEnabled && ShouldDestroy)
-			interrupts();
-	}
-
-protected:
-	bool const InterruptEnabled =
-#ifdef ARDUINO_ARCH_AVR
-	  SREG & 1 << SREG_I
-#endif
-#ifdef ARDUINO_ARCH_SAM
-	           !__get_PRIMASK()
-#endif
-	  ;
-	bool ShouldDestroy = true;
-};
-
-// 基于端口的异步读写流。端口的有效范围是0~254，255是无效端口号。
-class AsyncStream {
-	template<size_t Plus, typename T>
-	struct _PlusAndPrepend;
-	template<size_t Plus, size_t... Values>
-	struct _PlusAndPrepend<Plus, std::index_sequence<Values...>> {
-		using type = std::index_sequence<0, Plus + Values...>;
-	};
-
-	template<typename T>
-	struct _CumSum {
-		using type = std::index_sequence<>;
-	};
-	template<size_t First, size_t... Rest>
-	struct _CumSum<std::index_sequence<First, Rest...>> {
-		using type = typename _PlusAndPrepend<First, typename _CumSum<std::index_sequence<Rest...>>::type>::type;
-	};
-
-	template<typename...>
-	struct _TypesSize {
-		static constexpr MessageSize value = 0;
-	};
-	template<typename First, typename... Rest>
-	struct _TypesSize<First, Rest...> {
-		static constexpr MessageSize value = sizeof(First) + _TypesSize<Rest...>::value;
-	};
-
-	// 将内存区域复制到局部对象以避免严格别名和对象生存期引发的未定义行为
-	template<typename U>
-	static U ReadArgument(char const *ptr) {
-		U tmp;
-		memcpy(&tmp, ptr, sizeof(U));
-		return tmp;
-	}
-
-	template<typename T, typename = std::_FunctionSignature_t<T>>
-	struct _FunctionTraits;
-	template<typename TFunction, typename TReturn, typename... TArgument>
-	struct _FunctionTraits<TFunction, TReturn(TArgument...) const> {
-		static constexpr MessageSize ArgumentsSize = _TypesSize<TArgument...>::value;
-		template<typename = typename _CumSum<std::index_sequence<sizeof(TArgument)...>>::type>
-		struct InvokeWithMemoryOffsets;
-		// 必须用size_t，否则无法正确匹配模板
-		template<size_t... Offsets>
-		struct InvokeWithMemoryOffsets<std::index_sequence<Offsets...>> {
-#pragma pack(push, 1)
-			struct ReturnMessage {
-				Exception Result;
-				TReturn ReturnValue;
-			};
-#pragma pack(pop)
-			static ReturnMessage Invoke(TFunction const &Function, char const *Arguments) {
-				// 从字节缓冲读取参数到局部变量（避免严格别名与对象生存期 UB）
-				return { Exception::Success, Function((ReadArgument<TArgument>(Arguments + Offsets))...) };
-			}
-		};
-	};
-	template<typename TFunction, typename... TArgument>
-	struct _FunctionTraits<TFunction, void(TArgument...) const> {
-		static constexpr MessageSize ArgumentsSize = _TypesSize<TArgument...>::value;
-		template<typename = typename _CumSum<std::index_sequence<sizeof(TArgument)...>>::type>
-		struct InvokeWithMemoryOffsets;
-		template<MessageSize... Offsets>
-		struct InvokeWithMemoryOffsets<std::index_sequence<Offsets...>> {
-			static Exception Invoke(TFunction const &Function, char const *Arguments) {
-				Function((ReadArgument<TArgument>(Arguments + Offsets))...);
-				return Exception::Success;
-			}
-		};
-	};
-
-	Port _AllocatePort() const;
-
-	template<typename T, typename...>
-	struct TypeIfValid {
-		typedef T type;
-	};
-
-	std::unordered_map<Port, std::move_only_function<void(MessageSize) const>> _Listeners;
-
-	template<typename T>
-	struct FunctionListener {
-		FunctionListener(T &&Function, AsyncStream &Stream)
-		  : Function(std::forward<T>(Function)), Stream(Stream) {
-		}
-		void operator()(MessageSize MS) const {
-			if (MS < sizeof(Port)) {
-				if (sizeof(Port) > 1)
-					Stream.Skip(MS);
-				return;
-			}
-			Port const ReturnPort = Stream.Read<Port>();
-			MS -= sizeof(Port);
-			if (MS != _FunctionTraits<T>::ArgumentsSize) {
-				Stream.Skip(MS);
-				if (ReturnPort < 255)
-					Stream.Send(Exception::Argument_message_incomplete, ReturnPort);
-				return;
-			}
-			const std::unique_ptr<char[]> Arguments = std::make_unique_for_overwrite<char[]>(MS);
-			Stream.BaseStream.readBytes(Arguments.get(), MS);
-			auto const ReturnMessage = _FunctionTraits<T>::template InvokeWithMemoryOffsets<>::Invoke(Function, reinterpret_cast<char const *>(Arguments.get()));
-			if (ReturnPort < 255)
-				Stream.Send(ReturnMessage, ReturnPort);
-		}
-
-	protected:
-		T Function;
-		AsyncStream &Stream;
-	};
-	template<typename TCallback, typename = std::_FunctionSignature_t<TCallback>>
-	struct CallbackListener {
-		CallbackListener(TCallback &&Callback, AsyncStream &Stream, Port LocalPort)
-		  : Callback(std::forward<TCallback>(Callback)), Stream(Stream), LocalPort(LocalPort) {
-		}
-		void operator()(MessageSize MS) const {
-			Stream.ReleasePort(LocalPort);  // 此时PortForward已将本对象从_Listeners中移出到本地栈，因此释放端口不会释放本对象
-			if (MS == sizeof(Exception))
-				Callback(Stream.Read<Exception>());
-			else {
-				Stream.Skip(MS);
-				Callback(Exception::Corrupted_object_received);
-			}
-		}
-
-	protected:
-		TCallback Callback;
-		AsyncStream &Stream;
-		Port const LocalPort;
-	};
-	template<typename TCallback, typename TReturn>
-	struct CallbackListener<TCallback, void(Exception, TReturn) const> {
-		CallbackListener(TCallback &&Callback, AsyncStream &Stream, Port LocalPort)
-		  : Callback(std::forward<TCallback>(Callback)), Stream(Stream), LocalPort(LocalPort) {
-		}
-		void operator()(MessageSize MS) const {
-			Stream.ReleasePort(LocalPort);  // 此时PortForward已将本对象从_Listeners中移出到本地栈，因此释放端口不会释放本对象
-			switch (MS) {
-				case sizeof(Exception):
-					Callback(Stream.Read<Exception>(), {});
-					break;
-				case sizeof(Exception) + sizeof(TReturn):
-					{
-						Exception const E = Stream.Read<Exception>();
-						Callback(E, Stream.Read<TReturn>());
-					}
-					break;
-				default:
-					Stream.Skip(MS);
-					Callback(Exception::Corrupted_object_received, {});
-					break;
-			}
-		}
-
-	protected:
-		TCallback Callback;
-		AsyncStream &Stream;
-		Port const LocalPort;
-	};
-#pragma pack(push, 1)
-	// 只有两字节，没必要按引用传递
-	struct AsioHeader {
-		Port ToPort;
-		MessageSize Length;
-	};
-#pragma pack(pop)
-	void PortForward(AsioHeader Header);
-	void Flush();
-	template<typename... TArgument>
-	MessageSize SyncInvoke(Port RemotePort, TArgument... Arguments) {
-		Port const LocalPort = AllocatePort();
-		{
-			InterruptGuard const Session = BeginSend(sizeof(Port) + _TypesSize<TArgument...>::value, RemotePort);
-			*this << LocalPort;
-			int Written[] = { (*this << Arguments, 0)... };
-			// 必须在此处删除InterruptGuard以启用中断，因为下面要同步监听
-		}
-		MessageSize const MS = Listen(LocalPort);
-		ReleasePort(LocalPort);
-		return MS;
-	}
-	std::vector<byte> InputBuffer;
-	std::vector<byte> OutputBuffer;
-
-public:
-	// 从基础流读出平凡对象。只有在Listen方法允许的“手动从基础流读出”语境中才能使用此方法。
-	template<typename T>
-	AsyncStream const &operator>>(T &Value) const {
-		BaseStream.readBytes(reinterpret_cast<char *>(&Value), sizeof(T));
-		return *this;
-	}
-	// 从基础流读出平凡对象。只有在Listen方法允许的“手动从基础流读出”语境中才能使用此方法。
-	template<typename T>
-	T Read() const {
-		std::remove_const_t<T> Value;
-		BaseStream.readBytes(reinterpret_cast<char *>(&Value), sizeof(T));
-		return Value;
-	}
-	// 从基础流跳过指定长度的字节。只有在Listen方法允许的“手动从基础流读出”语境中才能使用此方法。
-	void Skip(MessageSize Length) const;
-
-	Stream &BaseStream;
-	/*
-					构造后，BaseStream将交由AsyncStream包装接管。不应再对BaseStream直接进行以下操作，否则行为未定义：
-						setTimeout，不支持此方法
-						write，应改用Send方法，或使用InterruptGuard。
-						readBytes，应改用Listen方法，仅在提供给Listen的回调中允许使用readBytes。
-					*/
-	AsyncStream(Stream &BaseStream = Serial)
-	  : BaseStream(BaseStream) {
-	}
-
-	/*
-					一般应在loop中调用此方法。它将实际执行所有排队中的监听器。调用此方法前，中断必须处于启用状态。这是因为串口操作需要中断支持，因此必须启用中断。用户在本库其它方法中提供的回调，将被此方法实际调用。所有被委托的Stream在此方法中实际被读。那些Stream的所有操作都应当托管给此方法，用户不应再直接访问那些Stream，否则行为未定义。
-					*/
-	void ExecuteTransactionsInQueue();
-
-	// 向远程ToPort发送指定Length的Message
-	void Send(const void *Message, MessageSize Length, Port ToPort);
-	// 向远程ToPort发送指定Message。这个Message对象应当允许直接序列化。
-	template<typename T>
-	inline void Send(const T &Message, Port ToPort) {
-		Send(&Message, sizeof(T), ToPort);
-	}
-	// 开始向远程ToPort发送指定Length的Message，并返回一个InterruptGuard对象以在当前作用域禁用中断直到作用域结束。在InterruptGuard的生命周期结束前，用户应当继续使用operator<<或Write方法将消息内容分批次写入缓冲区，直到总字节数恰好等于Length。用户不应在这个过程中恢复中断，也不应调用Send、BeginSend或直接写基础流，否则可能会破坏报文。
-	InterruptGuard BeginSend(MessageSize Length, Port ToPort);
-	//向报文中填入一个平凡对象。此方法只能在BeginSend返回的InterruptGuard对象的生命周期内使用。
-	template<typename T>
-	AsyncStream &operator<<(const T &Value) {
-		InputBuffer.insert(InputBuffer.end(), reinterpret_cast<const char *>(&Value), reinterpret_cast<const char *>(&Value + 1));
-		return *this;
-	}
-	//将一段字节缓冲拷入报文。此方法只能在BeginSend返回的InterruptGuard对象的生命周期内使用。
-	void Write(byte const *Data, MessageSize Length) {
-		InputBuffer.insert(InputBuffer.end(), Data, Data + Length);
-	}
-
-	// 分配一个空闲端口号。该端口号将保持被占用状态，不再参与自动分配，直到调用ReleasePort。此方法可能会分配到正在被同步监听或调用的端口，因为它们不视为对端口的占用。
-	Port AllocatePort();
-	// 检查指定端口Port是否被占用。此方法不能检测Port是否正被同步监听或调用，因为它们不视为对端口的占用。
-	bool PortOccupied(Port P) const {
-		InterruptGuard const _;
-		return _Listeners.contains(P);
-	}
-	// 立即释放指定本地端口，取消任何异步监听或绑定函数。不能取消同步监听或调用的，因为它们不视为对端口的占用。返回true表示成功释放了端口，false表示端口原本就未被占用。
-	bool ReleasePort(Port P) {
-		InterruptGuard const _;
-		return _Listeners.erase(P);
-	}
-
-	/*
-					异步监听本地FromPort端口。当远程传来指向FromPort的消息时，调用 void Callback(MessageSize)，由用户负责手动从基础流读出消息内容。在Callback返回之前，必须不多不少恰好读入全部MessageSize字节，否则行为未定义。
-					如果FromPort已被监听，将覆盖。
-					此监听是持续性的，每次收到消息都会重复调用Callback。如果需要停止监听，可以在Callback中或其它任何位置调用ReleasePort，也可以在那之后安全重用本端口。此方法保证Callback返回前不会被释放。
-					此方法保证Callback被调用时中断处于启用状态。
-					*/
-	template<typename T>
-	void Listen(T &&Callback, Port FromPort) {
-		InterruptGuard const _;
-		_Listeners[FromPort] = std::forward<T>(Callback);
-	}
-	/*
-					自动分配一个空闲端口并异步监听。当远程传来指向该端口的消息时，调用 void Callback(MessageSize)，由用户负责手动从基础流读出消息内容。在Callback返回之前，必须不多不少恰好读入全部MessageSize字节，否则行为未定义。返回分配的端口号。
-					此监听是持续性的，每次收到消息都会重复调用Callback。如果需要停止监听，可以在Callback中或其它任何位置调用ReleasePort。
-					此方法保证Callback被调用时中断处于启用状态。
-					Callback可以安全释放本端口，也可以在那之后安全重用本端口。此方法保证Callback返回前不会被释放。
-					*/
-	template<typename T>
-	Port Listen(T &&Callback) {
-		InterruptGuard const _;
-		Port const FromPort = _AllocatePort();
-		_Listeners[FromPort] = std::forward<T>(Callback);
-		return FromPort;
-	}
-	/*
-					同步监听一个本地端口。此重载必须在可中断语境中调用，否则可能永不返回。调用后将无限等待指定端口，直到其收到消息才会返回此消息的字节数。那之后，用户必须手动从基础流读出那个数目的字节。
-					此监听是同步的，优先于所有异步监听和调用。可以使用此方法监听已被异步监听或调用的端口，也可以在此方法等待期间发生的中断中对同一个端口添加异步监听和调用。在这些情境下，那个异步监听或调用不会比此同步监听更早收到消息，因为异步监听和调用实际上发生在ExecuteTransactionsInQueue中。
-					同步监听不占用端口。不能用ReleasePort取消同步监听，且同步监听中的端口可能被AllocatePort分配。
-					谨慎使用此重载。如果中断被禁止，此方法将永不返回。如果指定端口一直收不到消息，此方法也将永不返回。
-					*/
-	MessageSize Listen(Port FromPort);
-
-	/*
-					将任意可调用对象绑定到指定本地端口上作为服务，当收到消息时调用。如果端口被占用，将覆盖。
-					远程要调用此对象，需要将所有参数序列化拼接成一个连续的内存块，并且头部加上一个uint8_t的远程端口号用来接收返回值，然后将此消息发送到此函数绑定的本地端口。如果消息字节数不足，将向远程调用方发送Argument_message_incomplete。
-					Function的参数和返回值（如果有）必须是平凡类型。
-					此方法保证Function被调用时中断处于启用状态。
-					使用ReleasePort可以取消绑定，释放端口。
-					*/
-	template<typename T>
-	void BindFunctionToPort(T &&Function, Port P) {
-		Listen(FunctionListener<T>(std::forward<T>(Function), *this), P);
-	}
-
-	/*
-					将任意可调用对象绑定到自动分配的空闲端口上作为服务，当收到消息时调用。返回分配的端口号。
-					远程要调用此对象，需要将所有参数序列化拼接成一个连续的内存块，并且头部加上一个uint8_t的远程端口号用来接收返回值，然后将此消息发送到此函数绑定的本地端口。如果消息字节数不足，将向远程调用方发送Argument_message_incomplete异常。
-					Function的参数和返回值（如果有）必须是平凡类型。
-					此方法保证Function被调用时中断处于启用状态。
-					使用ReleasePort可以取消绑定，释放端口。
-					*/
-	template<typename T>
-	Port BindFunctionToPort(T &&Function) {
-		return Listen(FunctionListener<T>(std::forward<T>(Function), *this));
-	}
-
-	/*
-					异步调用指定RemotePort上的函数，传入任意参数Arguments，所有参数类型必须支持直接序列化。当远程函数返回时，将发送到LocalPort，然后调用 void Callback(Exception Result,ReturnType Return)，其中ReturnType必须与远程函数定义的返回值类型相同，且支持直接反序列化。如果远程函数没有返回值，则Callback必须只接受一个 Exception Result 参数。
-					如果远程端口未被监听，Callback将永不会被调用，但LocalPort会被持续占用，直到用户手动ReleasePort。
-					如果Result为Corrupted_object_received，说明收到了意外的返回值。这可能是因为远程函数返回值的类型与预期不符，或者有其它远程对象向本地端口发送了垃圾信息。此次远程调用将被废弃。
-					如果Result为Argument_message_incomplete，说明远程函数接收到的参数不完整。这可能是因为远程函数的参数类型与预期不符，或者有其它本地对象向远程端口发送了垃圾信息。此次远程调用将被废弃。
-					此方法保证Callback被调用时中断处于启用状态。
-					如果LocalPort已被占用，将覆盖。Callback被调用前，LocalPort已释放。
-					*/
-	template<typename TCallback, typename... TArgument>
-	std::void_t<std::_FunctionSignature_t<TCallback>> AsyncInvoke(Port RemotePort, Port LocalPort, TCallback &&Callback, TArgument... Arguments) {
-		Listen(CallbackListener<TCallback>(std::forward<TCallback>(Callback), *this, LocalPort), LocalPort);
-		InterruptGuard const Session = BeginSend(sizeof(Port) + _TypesSize<TArgument...>::value, RemotePort);
-		*this << LocalPort;
-		int Written[] = { (*this << Arguments, 0)... };
-	}
-	/*
-					异步调用指定RemotePort上的函数，传入任意参数Arguments，所有参数类型必须支持直接序列化。当远程函数返回时，将发送到自动分配的本地端口，然后调用 void Callback(Exception Result,ReturnType Return)，其中ReturnType必须与远程函数定义的返回值类型相同，且支持直接反序列化。如果远程函数没有返回值，则Callback必须只接受一个 Exception Result 参数。
-					如果远程端口未被监听，Callback将永不会被调用，但本地端口会被持续占用，直到用户手动ReleasePort。
-					如果Result为Corrupted_object_received，说明收到了意外的返回值。这可能是因为远程函数返回值的类型与预期不符，或者有其它远程对象向本地端口发送了垃圾信息。此次远程调用将被废弃。
-					如果Result为Argument_message_incomplete，说明远程函数接收到的参数不完整。这可能是因为远程函数的参数类型与预期不符，或者有其它本地对象向远程端口发送了垃圾信息。此次远程调用将被废弃。
-					此方法保证Callback被调用时中断处于启用状态。
-					此函数返回自动分配的本地端口，用户可以用ReleasePort释放此端口，将放弃等待远程函数的返回结果。Callback被调用前，会自动释放该本地端口。
-					*/
-	template<typename TCallback, typename... TArgument>
-	auto AsyncInvoke(Port RemotePort, TCallback &&Callback, TArgument... Arguments) -> decltype(static_cast<Port>((Callback(), 1))) {
-		Port const LocalPort = Listen(CallbackListener<TCallback>(std::forward<TCallback>(Callback), *this, LocalPort));
-		InterruptGuard const Session = BeginSend(sizeof(Port) + _TypesSize<TArgument...>::value, RemotePort);
-		*this << LocalPort;
-		int Written[] = { (*this << Arguments, 0)... };
-		return LocalPort;
-	}
-	// 异步调用指定RemotePort上的函数，传入任意参数Arguments，所有参数类型必须支持直接序列化。此重载不期待远程返回值，所以也不分配或占用本地端口。如果远程服务调用发生异常，也不会收到任何反馈。
-	template<typename... TArgument>
-	std::enable_if_t<std::conjunction<std::is_trivial<TArgument>...>::value> AsyncInvoke(Port RemotePort, TArgument... Arguments) {
-		InterruptGuard const Session = BeginSend(sizeof(Port) + _TypesSize<TArgument...>::value, RemotePort);
-		*this << std::numeric_limits<Port>::max();  // 使用无效端口号255，表示不期待返回值
-		int Written[] = { (*this << Arguments, 0)... };
-	}
-	/*
-					同步调用指定RemotePort上的函数，传入任意参数Arguments，所有参数类型必须支持直接序列化。尽管不期待返回值，此方法仍将内部分配一个空闲临时本地端口，然后无限等待，直到收到远程反馈成功或异常。
-					调用此方法前，中断必须处于启用状态。同步调用不占用端口，不能用ReleasePort取消同步调用。
-					谨慎使用此方法。如果中断被禁止，此方法将永不返回。如果远程一直不返回，此方法也将永不返回。
-					*/
-	template<typename... TArgument>
-	Exception SyncInvokeWithoutReturn(Port RemotePort, TArgument... Arguments) {
-		return SyncInvoke(RemotePort, Arguments...) == sizeof(Exception) ? Read<Exception>() : Exception::Corrupted_object_received;
-	}
-	/*
-					同步调用指定RemotePort上的函数，传入接受返回值的引用，以及任意参数Arguments，所有参数类型必须支持直接序列化。此方法将内部分配一个临时本地端口用于接收远程返回值，然后无限等待，直到收到远程返回消息，设置引用值，然后返回成功或异常。
-					调用此方法前，中断必须处于启用状态。同步调用不占用端口，不能用ReleasePort取消同步调用。
-					谨慎使用此方法。如果中断被禁止，此方法将永不返回。如果远程一直不返回，此方法也将永不返回。
-					*/
-	template<typename TReturn, typename... TArgument>
-	Exception SyncInvokeWithReturn(Port RemotePort, TReturn &ReturnValue, TArgument... Arguments) {
-		switch (MessageSize const MS = SyncInvoke(RemotePort, Arguments...)) {
-			case sizeof(Exception):
-				return Read<Exception>();
-			case sizeof(Exception) + sizeof(TReturn):
-				{
-					Exception const E = Read<Exception>();
-					*this >> ReturnValue;
-					return E;
-				}
-			default:
-				Skip(MS);
-				return Exception::Corrupted_object_received;
-		}
-	}
-};
+#pragma once
+#include <Cpp_Standard_Library.h>
+#include <memory>
+#include <functional>
+#include <limits>
+#include <Arduino.h>
+#undef min
+#undef max
+namespace Async_stream_IO {
+using MessageSize = uint16_t;
+using Port = uint8_t;
+enum class Exception : uint8_t {
+	Success,
+	Argument_message_incomplete,
+	Corrupted_object_received,
+	Function_runtime_error,
+	Message_received_on_allocated_port,
+	Unlistened_port_received_message,
+	Remote_function_have_no_return,
+	Serial_not_respond_in_time,
+};
+// 构造此临时对象以禁用中断并保存状态。当前作用域退出时，此对象析构并恢复之前的中断状态。
+struct InterruptGuard {
+	InterruptGuard() {
+		noInterrupts();
+	}
+	InterruptGuard(InterruptGuard const &) = delete;
+	InterruptGuard(InterruptGuard &&Other) noexcept
+	  : InterruptEnabled(Other.InterruptEnabled), ShouldDestroy(Other.ShouldDestroy) {
+		Other.ShouldDestroy = false;
+	}
+	~InterruptGuard() {
+		if (InterruptEnabled && ShouldDestroy)
+			interrupts();
+	}
+	// 检查当前中断是否处于启用状态
+	static bool Enabled() {
+		return
+#ifdef ARDUINO_ARCH_AVR
+		  SREG & 1 << SREG_I
+#endif
+#ifdef ARDUINO_ARCH_SAM
+		           !__get_PRIMASK()
+#endif
+		  ;
+	}
+	// 检查当前是否处于可以阻塞等待串口的主线程语境，即中断已启用且不在中断处理函数中
+	static bool ThreadContext() {
+		return Enabled()
+#ifdef ARDUINO_ARCH_SAM
+		       && !__get_IPSR()
+#endif
+		  ;
+	}
+
+protected:
+	bool const InterruptEnabled = Enabled();
+	bool ShouldDestroy = true;
+};
+
+// 发送缓冲区的字节容量，可在包含本头文件前定义此宏以覆盖默认值。单个报文（含4字节报头）超过此容量时，只能在主线程语境中直写基础流。
+#ifndef ASYNC_STREAM_IO_BUFFER_SIZE
+#ifdef ARDUINO_ARCH_AVR
+#define ASYNC_STREAM_IO_BUFFER_SIZE 256
+#endif
+#ifdef ARDUINO_ARCH_SAM
+#define ASYNC_STREAM_IO_BUFFER_SIZE 1024
+#endif
+#endif
+
+// 可同时占用的端口数上限，不超过255，可在包含本头文件前定义此宏以覆盖默认值。每个槽位存放一个监听器；端口到槽位的索引表固定为255字节，因此分发始终是两次数组寻址。
+#ifndef ASYNC_STREAM_IO_LISTENER_SLOTS
+#ifdef ARDUINO_ARCH_AVR
+#define ASYNC_STREAM_IO_LISTENER_SLOTS 32
+#endif
+#ifdef ARDUINO_ARCH_SAM
+#define ASYNC_STREAM_IO_LISTENER_SLOTS 255
+#endif
+#endif
+static_assert(ASYNC_STREAM_IO_LISTENER_SLOTS <= 255, "监听器槽位数不能超过端口数");
+
+// 定长位图，不使用堆内存。用于记录端口和监听器槽位的占用状态。
+template<uint16_t Bits>
+class Bitmap {
+	uint8_t Data[(Bits + 7) / 8] = {};
+
+public:
+	bool Test(uint8_t I) const {
+		return Data[I >> 3] & 1 << (I & 7);
+	}
+	void Set(uint8_t I) {
+		Data[I >> 3] |= 1 << (I & 7);
+	}
+	void Reset(uint8_t I) {
+		Data[I >> 3] &= ~(1 << (I & 7));
+	}
+	// 在[Begin,End)中查找第一个为0的位，整字节跳过已满的部分。找不到时返回End。
+	uint16_t FindFirstZero(uint16_t Begin = 0, uint16_t End = Bits) const {
+		while (Begin < End) {
+			// 屏蔽Begin之前的位
+			uint8_t const Byte = Data[Begin >> 3] | ((1 << (Begin & 7)) - 1);
+			if (Byte != 0xff) {
+				uint16_t const Found = (Begin & ~7) + __builtin_ctz(~Byte & 0xff);
+				return Found < End ? Found : End;
+			}
+			Begin = (Begin | 7) + 1;
+		}
+		return End;
+	}
+};
+
+// 固定容量的单消费者环形字节缓冲区，不使用堆内存。生产者必须在禁用中断时先Reserve再Put，消费者用Peek和Consume取出已写入的字节。
+template<MessageSize Capacity>
+class RingBuffer {
+	byte Data[Capacity];
+	MessageSize Head = 0;
+	MessageSize Used = 0;
+	MessageSize Reserved = 0;
+	MessageSize _HighWaterMark = 0;
+
+public:
+	// 中断不安全。为接下来的Put预留Length字节，空间不足时返回false且不预留。
+	bool Reserve(MessageSize Length) {
+		if (Length > Capacity - Used - Reserved)
+			return false;
+		Reserved += Length;
+		if (Used + Reserved > _HighWaterMark)
+			_HighWaterMark = Used + Reserved;
+		return true;
+	}
+	// 中断不安全。写入已预留的空间，超出预留的部分将被丢弃。
+	void Put(void const *Source, MessageSize Length) {
+		if (Length > Reserved)
+			Length = Reserved;
+		byte const *Bytes = reinterpret_cast<byte const *>(Source);
+		MessageSize Tail = Head + Used;
+		if (Tail >= Capacity)
+			Tail -= Capacity;
+		MessageSize const First = std::min<MessageSize>(Length, Capacity - Tail);
+		memcpy(Data + Tail, Bytes, First);
+		memcpy(Data, Bytes + First, Length - First);
+		Used += Length;
+		Reserved -= Length;
+	}
+	// 中断不安全。放弃尚未写入的预留空间
+	void CancelReservation() {
+		Reserved = 0;
+	}
+	// 中断不安全。返回从读取位置开始连续可读的字节数，并通过Bytes输出其起始地址。
+	MessageSize Peek(byte const *&Bytes) const {
+		Bytes = Data + Head;
+		return std::min<MessageSize>(Used, Capacity - Head);
+	}
+	// 中断不安全。释放已被消费者取走的Length字节
+	void Consume(MessageSize Length) {
+		Head += Length;
+		if (Head >= Capacity)
+			Head -= Capacity;
+		Used -= Length;
+	}
+	MessageSize Size() const {
+		return Used;
+	}
+	// 自启动以来缓冲区占用（含预留）的最大字节数
+	MessageSize HighWaterMark() const {
+		return _HighWaterMark;
+	}
+};
+
+#pragma pack(push, 1)
+// 发送缓冲区的运行统计
+struct StreamStatistics {
+	MessageSize BufferCapacity;
+	MessageSize HighWaterMark;
+	uint32_t DroppedFrames;
+};
+#pragma pack(pop)
+// 同步监听和调用的等待时限，单位毫秒。包装成结构体以免与端口号等整数参数混淆。
+struct Timeout {
+	uint32_t Milliseconds;
+};
+
+// 基于端口的异步读写流。端口的有效范围是0~254，255是无效端口号。
+class AsyncStream {
+	template<size_t Plus, typename T>
+	struct _PlusAndPrepend;
+	template<size_t Plus, size_t... Values>
+	struct _PlusAndPrepend<Plus, std::index_sequence<Values...>> {
+		using type = std::index_sequence<0, Plus + Values...>;
+	};
+
+	template<typename T>
+	struct _CumSum {
+		using type = std::index_sequence<>;
+	};
+	template<size_t First, size_t... Rest>
+	struct _CumSum<std::index_sequence<First, Rest...>> {
+		using type = typename _PlusAndPrepend<First, typename _CumSum<std::index_sequence<Rest...>>::type>::type;
+	};
+
+	template<typename...>
+	struct _TypesSize {
+		static constexpr MessageSize value = 0;
+	};
+	template<typename First, typename... Rest>
+	struct _TypesSize<First, Rest...> {
+		static constexpr MessageSize value = sizeof(First) + _TypesSize<Rest...>::value;
+	};
+
+	// 将内存区域复制到局部对象以避免严格别名和对象生存期引发的未定义行为
+	template<typename U>
+	static U ReadArgument(char const *ptr) {
+		U tmp;
+		memcpy(&tmp, ptr, sizeof(U));
+		return tmp;
+	}
+
+	template<typename T, typename = std::_FunctionSignature_t<T>>
+	struct _FunctionTraits;
+	template<typename TFunction, typename TReturn, typename... TArgument>
+	struct _FunctionTraits<TFunction, TReturn(TArgument...) const> {
+		static constexpr MessageSize ArgumentsSize = _TypesSize<TArgument...>::value;
+		template<typename = typename _CumSum<std::index_sequence<sizeof(TArgument)...>>::type>
+		struct InvokeWithMemoryOffsets;
+		// 必须用size_t，否则无法正确匹配模板
+		template<size_t... Offsets>
+		struct InvokeWithMemoryOffsets<std::index_sequence<Offsets...>> {
+#pragma pack(push, 1)
+			struct ReturnMessage {
+				Exception Result;
+				TReturn ReturnValue;
+			};
+#pragma pack(pop)
+			static ReturnMessage Invoke(TFunction const &Function, char const *Arguments) {
+				// 从字节缓冲读取参数到局部变量（避免严格别名与对象生存期 UB）
+				return { Exception::Success, Function((ReadArgument<TArgument>(Arguments + Offsets))...) };
+			}
+		};
+	};
+	template<typename TFunction, typename... TArgument>
+	struct _FunctionTraits<TFunction, void(TArgument...) const> {
+		static constexpr MessageSize ArgumentsSize = _TypesSize<TArgument...>::value;
+		template<typename = typename _CumSum<std::index_sequence<sizeof(TArgument)...>>::type>
+		struct InvokeWithMemoryOffsets;
+		// 必须用size_t，否则无法正确匹配模板
+		template<size_t... Offsets>
+		struct InvokeWithMemoryOffsets<std::index_sequence<Offsets...>> {
+			static Exception Invoke(TFunction const &Function, char const *Arguments) {
+				Function((ReadArgument<TArgument>(Arguments + Offsets))...);
+				return Exception::Success;
+			}
+		};
+	};
+
+	// 分配一个空闲端口，同时要求有空闲的监听器槽位。从上次分配的端口之后开始循环查找。端口或槽位耗尽时返回255。
+	Port _AllocatePort();
+	// 取得已占用端口P的监听器槽位。P未被占用时，为其分配一个空闲槽位。槽位耗尽时返回nullptr。
+	std::move_only_function<void(MessageSize) const> *_ListenerSlot(Port P);
+
+	template<typename T, typename...>
+	struct TypeIfValid {
+		typedef T type;
+	};
+
+	// 端口表：_PortBitmap标记被占用的端口，_PortSlots将被占用的端口映射到_Listeners中的槽位，_SlotBitmap标记被占用的槽位。_PortSlots只对被占用的端口有效。
+	Bitmap<255> _PortBitmap;
+	Bitmap<ASYNC_STREAM_IO_LISTENER_SLOTS> _SlotBitmap;
+	uint8_t _PortSlots[255];
+	std::move_only_function<void(MessageSize) const> _Listeners[ASYNC_STREAM_IO_LISTENER_SLOTS];
+	Port _NextPort = 0;
+
+	template<typename T>
+	struct FunctionListener {
+		FunctionListener(T &&Function, AsyncStream &Stream)
+		  : Function(std::forward<T>(Function)), Stream(Stream) {
+		}
+		void operator()(MessageSize MS) const {
+			if (MS < sizeof(Port)) {
+				if (sizeof(Port) > 1)
+					Stream.Skip(MS);
+				return;
+			}
+			Port const ReturnPort = Stream.Read<Port>();
+			MS -= sizeof(Port);
+			if (MS != _FunctionTraits<T>::ArgumentsSize) {
+				Stream.Skip(MS);
+				if (ReturnPort < 255)
+					Stream.Send(Exception::Argument_message_incomplete, ReturnPort);
+				return;
+			}
+			// 参数总长在编译期已知，直接读入栈上缓冲，不分配堆内存。零长数组不合法，至少保留1字节。
+			char Arguments[_FunctionTraits<T>::ArgumentsSize ? _FunctionTraits<T>::ArgumentsSize : 1];
+			Stream.BaseStream.readBytes(Arguments, MS);
+			auto const ReturnMessage = _FunctionTraits<T>::template InvokeWithMemoryOffsets<>::Invoke(Function, Arguments);
+			if (ReturnPort < 255)
+				Stream.Send(ReturnMessage, ReturnPort);
+		}
+
+	protected:
+		T Function;
+		AsyncStream &Stream;
+	};
+	template<typename TCallback, typename = std::_FunctionSignature_t<TCallback>>
+	struct CallbackListener {
+		CallbackListener(TCallback &&Callback, AsyncStream &Stream, Port LocalPort)
+		  : Callback(std::forward<TCallback>(Callback)), Stream(Stream), LocalPort(LocalPort) {
+		}
+		void operator()(MessageSize MS) const {
+			Stream.ReleasePort(LocalPort);  // 此时PortForward已将本对象从_Listeners中移出到本地栈，因此释放端口不会释放本对象
+			if (MS == sizeof(Exception))
+				Callback(Stream.Read<Exception>());
+			else {
+				Stream.Skip(MS);
+				Callback(Exception::Corrupted_object_received);
+			}
+		}
+
+	protected:
+		TCallback Callback;
+		AsyncStream &Stream;
+		Port const LocalPort;
+	};
+	template<typename TCallback, typename TReturn>
+	struct CallbackListener<TCallback, void(Exception, TReturn) const> {
+		CallbackListener(TCallback &&Callback, AsyncStream &Stream, Port LocalPort)
+		  : Callback(std::forward<TCallback>(Callback)), Stream(Stream), LocalPort(LocalPort) {
+		}
+		void operator()(MessageSize MS) const {
+			Stream.ReleasePort(LocalPort);  // 此时PortForward已将本对象从_Listeners中移出到本地栈，因此释放端口不会释放本对象
+			switch (MS) {
+				case sizeof(Exception):
+					Callback(Stream.Read<Exception>(), {});
+					break;
+				case sizeof(Exception) + sizeof(TReturn):
+					{
+						Exception const E = Stream.Read<Exception>();
+						Callback(E, Stream.Read<TReturn>());
+					}
+					break;
+				default:
+					Stream.Skip(MS);
+					Callback(Exception::Corrupted_object_received, {});
+					break;
+			}
+		}
+
+	protected:
+		TCallback Callback;
+		AsyncStream &Stream;
+		Port const LocalPort;
+	};
+#pragma pack(push, 1)
+	// 只有两字节，没必要按引用传递
+	struct AsioHeader {
+		Port ToPort;
+		MessageSize Length;
+	};
+#pragma pack(pop)
+	void PortForward(AsioHeader Header);
+	// 从发送缓冲区连续写出至多Budget字节到基础流，返回实际写出的字节数。调用前中断必须处于启用状态。
+	MessageSize _WriteOut(MessageSize Budget);
+	// 只写出基础流发送缓冲当前能容纳的字节，不阻塞；余下的留待下次调用继续写出。调用前中断必须处于启用状态。
+	void FlushAvailable();
+	template<typename... TArgument>
+	MessageSize SyncInvoke(Port RemotePort, TArgument... Arguments) {
+		Port const LocalPort = AllocatePort();
+		{
+			SendSession const Session = BeginSend(sizeof(Port) + _TypesSize<TArgument...>::value, RemotePort);
+			*this << LocalPort;
+			int Written[] = { (*this << Arguments, 0)... };
+			// 必须在此处结束SendSession以启用中断，因为下面要同步监听
+		}
+		MessageSize const MS = Listen(LocalPort);
+		ReleasePort(LocalPort);
+		return MS;
+	}
+	template<typename... TArgument>
+	Exception SyncInvoke(Timeout Limit, MessageSize &Length, Port RemotePort, TArgument... Arguments) {
+		Port const LocalPort = AllocatePort();
+		{
+			SendSession const Session = BeginSend(sizeof(Port) + _TypesSize<TArgument...>::value, RemotePort);
+			*this << LocalPort;
+			int Written[] = { (*this << Arguments, 0)... };
+		}
+		Exception const Result = Listen(LocalPort, Limit, Length);
+		ReleasePort(LocalPort);
+		return Result;
+	}
+	// 从基础流读出一条远程函数的返回消息
+	template<typename TReturn>
+	Exception _ReadReturn(MessageSize MS, TReturn &ReturnValue) {
+		switch (MS) {
+			case sizeof(Exception):
+				return Read<Exception>();
+			case sizeof(Exception) + sizeof(TReturn):
+				{
+					Exception const E = Read<Exception>();
+					*this >> ReturnValue;
+					return E;
+				}
+			default:
+				Skip(MS);
+				return Exception::Corrupted_object_received;
+		}
+	}
+	// 限时等待基础流至少有Bytes个字节可读，超时返回false。等待期间反复调用WaitingCallback。
+	bool _WaitAvailable(int Bytes, uint32_t Start, uint32_t Milliseconds);
+	// 限时从基础流跳过Length个字节，超时返回false。报文可能长于基础流的接收缓冲，因此边到达边丢弃，而不是等待全部到达；无数据可读时调用WaitingCallback。
+	bool _SkipWithin(MessageSize Length, uint32_t Start, uint32_t Milliseconds);
+
+	enum class _SendMode : uint8_t {
+		Buffer,   // 写入发送缓冲区，由ExecuteTransactionsInQueue发出
+		Direct,   // 报文超过缓冲区容量，在主线程语境中直写基础流
+		Discard,  // 缓冲区已满且无法等待，丢弃整个报文
+	};
+	RingBuffer<ASYNC_STREAM_IO_BUFFER_SIZE> OutputBuffer;
+	_SendMode SendMode = _SendMode::Buffer;
+	uint32_t DroppedFrames = 0;
+
+public:
+	// BeginSend返回的报文会话。在其生命周期内中断被禁用（直写模式除外），析构时恢复之前的中断状态。此对象只能移动，不能转换为InterruptGuard，否则报文无法正确结束。
+	class SendSession {
+		friend class AsyncStream;
+		InterruptGuard Guard;
+		AsyncStream &Stream;
+		_SendMode const PreviousMode;
+		bool Active = true;
+		SendSession(AsyncStream &Stream)
+		  : Stream(Stream), PreviousMode(Stream.SendMode) {
+		}
+
+	public:
+		SendSession(SendSession &&Other) noexcept
+		  : Guard(std::move(Other.Guard)), Stream(Other.Stream), PreviousMode(Other.PreviousMode) {
+			Other.Active = false;
+		}
+		~SendSession() {
+			if (Active) {
+				// 直写模式下中断已启用，必须先禁用再改写共享状态
+				noInterrupts();
+				Stream.OutputBuffer.CancelReservation();
+				Stream.SendMode = PreviousMode;
+			}
+		}
+	};
+
+protected:
+	// 在发送缓冲区中预留FrameLength字节并返回会话，由调用方写入报头
+	SendSession _BeginFrame(MessageSize FrameLength);
+
+public:
+	// 从基础流读出平凡对象。只有在Listen方法允许的“手动从基础流读出”语境中才能使用此方法。
+	template<typename T>
+	AsyncStream const &operator>>(T &Value) const {
+		BaseStream.readBytes(reinterpret_cast<char *>(&Value), sizeof(T));
+		return *this;
+	}
+	// 从基础流读出平凡对象。只有在Listen方法允许的“手动从基础流读出”语境中才能使用此方法。
+	template<typename T>
+	T Read() const {
+		std::remove_const_t<T> Value;
+		BaseStream.readBytes(reinterpret_cast<char *>(&Value), sizeof(T));
+		return Value;
+	}
+	// 从基础流跳过指定长度的字节。只有在Listen方法允许的“手动从基础流读出”语境中才能使用此方法。
+	void Skip(MessageSize Length) const;
+
+	Stream &BaseStream;
+	/*
+					构造后，BaseStream将交由AsyncStream包装接管。不应再对BaseStream直接进行以下操作，否则行为未定义：
+						setTimeout，不支持此方法
+						write，应改用Send方法，或使用InterruptGuard。
+						readBytes，应改用Listen方法，仅在提供给Listen的回调中允许使用readBytes。
+					*/
+	AsyncStream(Stream &BaseStream = Serial)
+	  : BaseStream(BaseStream) {
+	}
+
+	/*
+					为true时，ExecuteTransactionsInQueue每次只向基础流写出其availableForWrite所示的字节数，不会因等待串口发送而阻塞，未写完的部分在下次调用时继续，从而使loop中其它任务的延迟不受大报文拖累。为false时，ExecuteTransactionsInQueue将阻塞直到发送缓冲区全部写出。
+					只有BaseStream正确实现了availableForWrite时才能设为true，否则报文将永远无法发出。同步监听和调用总是阻塞写出全部缓冲。
+					*/
+	bool BudgetedFlush = true;
+
+	/*
+					一般应在loop中调用此方法。它将写出发送缓冲区（参见BudgetedFlush），并实际执行所有排队中的监听器。调用此方法前，中断必须处于启用状态。这是因为串口操作需要中断支持，因此必须启用中断。用户在本库其它方法中提供的回调，将被此方法实际调用。所有被委托的Stream在此方法中实际被读。那些Stream的所有操作都应当托管给此方法，用户不应再直接访问那些Stream，否则行为未定义。
+					*/
+	void ExecuteTransactionsInQueue();
+
+	// 向远程ToPort发送指定Length的Message
+	void Send(const void *Message, MessageSize Length, Port ToPort);
+	// 向远程ToPort发送指定Message。这个Message对象应当允许直接序列化。
+	template<typename T>
+	inline void Send(const T &Message, Port ToPort) {
+		Send(&Message, sizeof(T), ToPort);
+	}
+	/*
+					开始向远程ToPort发送指定Length的Message，并返回一个SendSession对象以在当前作用域禁用中断直到作用域结束。在SendSession的生命周期结束前，用户应当继续使用operator<<或Write方法将消息内容分批次写入缓冲区，直到总字节数恰好等于Length。用户不应在这个过程中恢复中断，也不应调用Send、BeginSend或直接写基础流，否则可能会破坏报文。
+					发送缓冲区容量固定，不会分配堆内存。缓冲区不足时，如果在主线程语境中调用，将阻塞等待缓冲区发出；报文本身超过缓冲区容量的，将在启用中断的状态下直写基础流。在中断处理函数或禁用中断的语境中调用时不能等待，整个报文将被丢弃并计入DroppedFrames。
+					*/
+	SendSession BeginSend(MessageSize Length, Port ToPort);
+	/*
+					同BeginSend，但使用紧凑报头：1字节长度代替2字节，总计3字节报头，因此Length不能超过255。适用于高频发送的短报文，例如不期待返回值、也不带返回端口号的事件通知。远程必须能够识别紧凑报头。紧凑报头只用于发送方向，本端接收时不识别，远程发来的报文必须使用标准报头。
+					*/
+	SendSession BeginCompactSend(uint8_t Length, Port ToPort);
+	//向报文中填入一个平凡对象。此方法只能在BeginSend返回的SendSession对象的生命周期内使用。
+	template<typename T>
+	AsyncStream &operator<<(const T &Value) {
+		Write(reinterpret_cast<byte const *>(&Value), sizeof(T));
+		return *this;
+	}
+	//将一段字节缓冲拷入报文。此方法只能在BeginSend返回的SendSession对象的生命周期内使用。
+	void Write(byte const *Data, MessageSize Length);
+	//同Write，但Data位于闪存（PROGMEM）中。
+	void WriteFlash(byte const *Data, MessageSize Length);
+	// 阻塞直到发送缓冲区全部写入基础流。调用前中断必须处于启用状态，且不能在BeginSend会话中调用。
+	void Flush();
+	// 限时同步监听和调用等待期间反复调用的函数，可用于处理其它必须及时响应的事务。为nullptr时不调用。
+	void (*WaitingCallback)() = nullptr;
+	// 当前报文是否因发送缓冲区已满而被丢弃。只能在SendSession的生命周期内调用。
+	bool Discarding() const {
+		return SendMode == _SendMode::Discard;
+	}
+	// 获取发送缓冲区的运行统计。中断安全。
+	StreamStatistics Statistics() const {
+		InterruptGuard const _;
+		return { ASYNC_STREAM_IO_BUFFER_SIZE, OutputBuffer.HighWaterMark(), DroppedFrames };
+	}
+
+	// 分配一个空闲端口号。该端口号将保持被占用状态，不再参与自动分配，直到调用ReleasePort。此方法可能会分配到正在被同步监听或调用的端口，因为它们不视为对端口的占用。端口或监听器槽位耗尽时返回255。
+	Port AllocatePort();
+	// 检查指定端口Port是否被占用。此方法不能检测Port是否正被同步监听或调用，因为它们不视为对端口的占用。
+	bool PortOccupied(Port P) const {
+		InterruptGuard const _;
+		return P < 255 && _PortBitmap.Test(P);
+	}
+	// 立即释放指定本地端口，取消任何异步监听或绑定函数。不能取消同步监听或调用的，因为它们不视为对端口的占用。返回true表示成功释放了端口，false表示端口原本就未被占用。
+	bool ReleasePort(Port P);
+
+	/*
+					异步监听本地FromPort端口。当远程传来指向FromPort的消息时，调用 void Callback(MessageSize)，由用户负责手动从基础流读出消息内容。在Callback返回之前，必须不多不少恰好读入全部MessageSize字节，否则行为未定义。
+					如果FromPort已被监听，将覆盖。返回是否成功监听：FromPort未被监听且监听器槽位已耗尽时返回false，Callback将被丢弃，调用方必须检查返回值。
+					此监听是持续性的，每次收到消息都会重复调用Callback。如果需要停止监听，可以在Callback中或其它任何位置调用ReleasePort，也可以在那之后安全重用本端口。此方法保证Callback返回前不会被释放。
+					此方法保证Callback被调用时中断处于启用状态。
+					*/
+	template<typename T>
+	[[nodiscard]] bool Listen(T &&Callback, Port FromPort) {
+		InterruptGuard const _;
+		std::move_only_function<void(MessageSize) const> *const Slot = _ListenerSlot(FromPort);
+		if (Slot)
+			*Slot = std::forward<T>(Callback);
+		return Slot;
+	}
+	/*
+					自动分配一个空闲端口并异步监听。当远程传来指向该端口的消息时，调用 void Callback(MessageSize)，由用户负责手动从基础流读出消息内容。在Callback返回之前，必须不多不少恰好读入全部MessageSize字节，否则行为未定义。返回分配的端口号。端口或监听器槽位耗尽时返回255，Callback将被丢弃。
+					此监听是持续性的，每次收到消息都会重复调用Callback。如果需要停止监听，可以在Callback中或其它任何位置调用ReleasePort。
+					此方法保证Callback被调用时中断处于启用状态。
+					Callback可以安全释放本端口，也可以在那之后安全重用本端口。此方法保证Callback返回前不会被释放。
+					*/
+	template<typename T>
+	Port Listen(T &&Callback) {
+		InterruptGuard const _;
+		Port const FromPort = _AllocatePort();
+		if (FromPort < 255)
+			*_ListenerSlot(FromPort) = std::forward<T>(Callback);
+		return FromPort;
+	}
+	/*
+					同步监听一个本地端口。此重载必须在可中断语境中调用，否则可能永不返回。调用后将无限等待指定端口，直到其收到消息才会返回此消息的字节数。那之后，用户必须手动从基础流读出那个数目的字节。
+					此监听是同步的，优先于所有异步监听和调用。可以使用此方法监听已被异步监听或调用的端口，也可以在此方法等待期间发生的中断中对同一个端口添加异步监听和调用。在这些情境下，那个异步监听或调用不会比此同步监听更早收到消息，因为异步监听和调用实际上发生在ExecuteTransactionsInQueue中。
+					同步监听不占用端口。不能用ReleasePort取消同步监听，且同步监听中的端口可能被AllocatePort分配。
+					谨慎使用此重载。如果中断被禁止，此方法将永不返回。如果指定端口一直收不到消息，此方法也将永不返回。
+					*/
+	MessageSize Listen(Port FromPort);
+	/*
+					限时同步监听一个本地端口。在Limit时限内收到指向FromPort的消息时，将其字节数写入Length并返回Success，那之后用户必须手动从基础流读出那个数目的字节；超时则返回Serial_not_respond_in_time，Length不变。
+					与无限等待的重载不同，等待期间只在基础流已有数据时才读入，其它端口的消息照常转发给各自的异步监听器，并反复调用WaitingCallback，因此远程掉线不会使主线程永久阻塞。报头不完整时也只等待到时限为止；发往未监听端口的报文同样限时跳过。但目标端口的报文内容仍由用户按基础流自身的超时设置读出，转发给异步监听器的报文也由监听器自行读出，不受此时限约束，远程在这些报文中途掉线仍可能阻塞。
+					此重载必须在可中断语境中调用。同步监听不占用端口。
+					*/
+	Exception Listen(Port FromPort, Timeout Limit, MessageSize &Length);
+
+	/*
+					将任意可调用对象绑定到指定本地端口上作为服务，当收到消息时调用。如果端口被占用，将覆盖。
+					远程要调用此对象，需要将所有参数序列化拼接成一个连续的内存块，并且头部加上一个uint8_t的远程端口号用来接收返回值，然后将此消息发送到此函数绑定的本地端口。如果消息字节数不足，将向远程调用方发送Argument_message_incomplete。
+					Function的参数和返回值（如果有）必须是平凡类型。
+					此方法保证Function被调用时中断处于启用状态。
+					使用ReleasePort可以取消绑定，释放端口。
+					返回是否成功绑定。P未被占用且监听器槽位已耗尽时返回false，Function将被丢弃。
+					*/
+	template<typename T>
+	[[nodiscard]] bool BindFunctionToPort(T &&Function, Port P) {
+		return Listen(FunctionListener<T>(std::forward<T>(Function), *this), P);
+	}
+
+	/*
+					将任意可调用对象绑定到自动分配的空闲端口上作为服务，当收到消息时调用。返回分配的端口号。
+					远程要调用此对象，需要将所有参数序列化拼接成一个连续的内存块，并且头部加上一个uint8_t的远程端口号用来接收返回值，然后将此消息发送到此函数绑定的本地端口。如果消息字节数不足，将向远程调用方发送Argument_message_incomplete异常。
+					Function的参数和返回值（如果有）必须是平凡类型。
+					此方法保证Function被调用时中断处于启用状态。
+					使用ReleasePort可以取消绑定，释放端口。
+					*/
+	template<typename T>
+	Port BindFunctionToPort(T &&Function) {
+		return Listen(FunctionListener<T>(std::forward<T>(Function), *this));
+	}
+
+	/*
+					异步调用指定RemotePort上的函数，传入任意参数Arguments，所有参数类型必须支持直接序列化。当远程函数返回时，将发送到LocalPort，然后调用 void Callback(Exception Result,ReturnType Return)，其中ReturnType必须与远程函数定义的返回值类型相同，且支持直接反序列化。如果远程函数没有返回值，则Callback必须只接受一个 Exception Result 参数。
+					如果远程端口未被监听，Callback将永不会被调用，但LocalPort会被持续占用，直到用户手动ReleasePort。
+					如果Result为Corrupted_object_received，说明收到了意外的返回值。这可能是因为远程函数返回值的类型与预期不符，或者有其它远程对象向本地端口发送了垃圾信息。此次远程调用将被废弃。
+					如果Result为Argument_message_incomplete，说明远程函数接收到的参数不完整。这可能是因为远程函数的参数类型与预期不符，或者有其它本地对象向远程端口发送了垃圾信息。此次远程调用将被废弃。
+					此方法保证Callback被调用时中断处于启用状态。
+					如果LocalPort已被占用，将覆盖。Callback被调用前，LocalPort已释放。
+					返回是否已发出调用。LocalPort未被占用且监听器槽位已耗尽时返回false，不会发出调用，Callback将被丢弃。
+					*/
+	template<typename TCallback, typename... TArgument>
+	auto AsyncInvoke(Port RemotePort, Port LocalPort, TCallback &&Callback, TArgument... Arguments) -> decltype(std::declval<std::_FunctionSignature_t<TCallback> *>(), bool()) {
+		if (!Listen(CallbackListener<TCallback>(std::forward<TCallback>(Callback), *this, LocalPort), LocalPort))
+			return false;
+		SendSession const Session = BeginSend(sizeof(Port) + _TypesSize<TArgument...>::value, RemotePort);
+		*this << LocalPort;
+		int Written[] = { (*this << Arguments, 0)... };
+		return true;
+	}
+	/*
+					异步调用指定RemotePort上的函数，传入任意参数Arguments，所有参数类型必须支持直接序列化。当远程函数返回时，将发送到自动分配的本地端口，然后调用 void Callback(Exception Result,ReturnType Return)，其中ReturnType必须与远程函数定义的返回值类型相同，且支持直接反序列化。如果远程函数没有返回值，则Callback必须只接受一个 Exception Result 参数。
+					如果远程端口未被监听，Callback将永不会被调用，但本地端口会被持续占用，直到用户手动ReleasePort。
+					如果Result为Corrupted_object_received，说明收到了意外的返回值。这可能是因为远程函数返回值的类型与预期不符，或者有其它远程对象向本地端口发送了垃圾信息。此次远程调用将被废弃。
+					如果Result为Argument_message_incomplete，说明远程函数接收到的参数不完整。这可能是因为远程函数的参数类型与预期不符，或者有其它本地对象向远程端口发送了垃圾信息。此次远程调用将被废弃。
+					此方法保证Callback被调用时中断处于启用状态。
+					此函数返回自动分配的本地端口，用户可以用ReleasePort释放此端口，将放弃等待远程函数的返回结果。Callback被调用前，会自动释放该本地端口。
+					*/
+	template<typename TCallback, typename... TArgument>
+	auto AsyncInvoke(Port RemotePort, TCallback &&Callback, TArgument... Arguments) -> decltype(static_cast<Port>((Callback(), 1))) {
+		Port const LocalPort = Listen(CallbackListener<TCallback>(std::forward<TCallback>(Callback), *this, LocalPort));
+		SendSession const Session = BeginSend(sizeof(Port) + _TypesSize<TArgument...>::value, RemotePort);
+		*this << LocalPort;
+		int Written[] = { (*this << Arguments, 0)... };
+		return LocalPort;
+	}
+	// 异步调用指定RemotePort上的函数，传入任意参数Arguments，所有参数类型必须支持直接序列化。此重载不期待远程返回值，所以也不分配或占用本地端口。如果远程服务调用发生异常，也不会收到任何反馈。
+	template<typename... TArgument>
+	std::enable_if_t<std::conjunction<std::is_trivial<TArgument>...>::value> AsyncInvoke(Port RemotePort, TArgument... Arguments) {
+		SendSession const Session = BeginSend(sizeof(Port) + _TypesSize<TArgument...>::value, RemotePort);
+		*this << std::numeric_limits<Port>::max();  // 使用无效端口号255，表示不期待返回值
+		int Written[] = { (*this << Arguments, 0)... };
+	}
+	/*
+					同步调用指定RemotePort上的函数，传入任意参数Arguments，所有参数类型必须支持直接序列化。尽管不期待返回值，此方法仍将内部分配一个空闲临时本地端口，然后无限等待，直到收到远程反馈成功或异常。
+					调用此方法前，中断必须处于启用状态。同步调用不占用端口，不能用ReleasePort取消同步调用。
+					谨慎使用此方法。如果中断被禁止，此方法将永不返回。如果远程一直不返回，此方法也将永不返回。
+					*/
+	template<typename... TArgument>
+	Exception SyncInvokeWithoutReturn(Port RemotePort, TArgument... Arguments) {
+		return SyncInvoke(RemotePort, Arguments...) == sizeof(Exception) ? Read<Exception>() : Exception::Corrupted_object_received;
+	}
+	/*
+					同步调用指定RemotePort上的函数，传入接受返回值的引用，以及任意参数Arguments，所有参数类型必须支持直接序列化。此方法将内部分配一个临时本地端口用于接收远程返回值，然后无限等待，直到收到远程返回消息，设置引用值，然后返回成功或异常。
+					调用此方法前，中断必须处于启用状态。同步调用不占用端口，不能用ReleasePort取消同步调用。
+					谨慎使用此方法。如果中断被禁止，此方法将永不返回。如果远程一直不返回，此方法也将永不返回。
+					*/
+	template<typename TReturn, typename... TArgument>
+	Exception SyncInvokeWithReturn(Port RemotePort, TReturn &ReturnValue, TArgument... Arguments) {
+		return _ReadReturn(SyncInvoke(RemotePort, Arguments...), ReturnValue);
+	}
+	/*
+					同SyncInvokeWithoutReturn，但最多等待Limit时限。超时返回Serial_not_respond_in_time，迟到的远程反馈将被当作发往未监听端口的消息丢弃。等待期间照常转发其它端口的消息，并反复调用WaitingCallback。
+					调用此方法前，中断必须处于启用状态。
+					*/
+	template<typename... TArgument>
+	Exception SyncInvokeWithoutReturn(Timeout Limit, Port RemotePort, TArgument... Arguments) {
+		MessageSize MS;
+		if (Exception const E = SyncInvoke(Limit, MS, RemotePort, Arguments...); E != Exception::Success)
+			return E;
+		if (MS == sizeof(Exception))
+			return Read<Exception>();
+		Skip(MS);
+		return Exception::Corrupted_object_received;
+	}
+	/*
+					同SyncInvokeWithReturn，但最多等待Limit时限。超时返回Serial_not_respond_in_time，ReturnValue不变，迟到的远程返回值将被当作发往未监听端口的消息丢弃。等待期间照常转发其它端口的消息，并反复调用WaitingCallback。
+					调用此方法前，中断必须处于启用状态。
+					*/
+	template<typename TReturn, typename... TArgument>
+	Exception SyncInvokeWithReturn(Timeout Limit, Port RemotePort, TReturn &ReturnValue, TArgument... Arguments) {
+		MessageSize MS;
+		if (Exception const E = SyncInvoke(Limit, MS, RemotePort, Arguments...); E != Exception::Success)
+			return E;
+		return _ReadReturn(MS, ReturnValue);
+	}
+};
 }
\ No newline at end of file
@@ -9,22 +9,168 @@ struct ModuleStartReturn {
 	UID GbecException;
 	uint16_t NumTrials;
 };
+// Module为模块类型的ID；进程无效、序号越界或未插桩时为相应的异常UID
+struct ModuleAllocationReturn {
+	UID Module;
+	uint16_t Load;
+	uint16_t Run;
+};
+struct StreamStatisticsReturn {
+	Async_stream_IO::StreamStatistics Stream;
+	uint16_t DroppedEventBatches;
+};
+// IsrCount为UINT32_MAX表示未插桩；QueueCapacity为0表示未推迟计时器续延
+struct TimerStatisticsReturn {
+	uint32_t IsrCount;
+	uint32_t IsrTotalMicros;
+	uint32_t IsrMaxMicros;
+	uint8_t QueueCapacity;
+	uint8_t QueueHighWater;
+	uint16_t QueueOverflows;
+};
 #pragma pack(pop)
-std::map<uint8_t, PinListener::PinState> PinListener::PinStates;
-std::move_only_function<void()> Module::_EmptyCallback{ []() {} };
+PinListener::PinState PinListener::PinStates[NUM_DIGITAL_PINS];
+uint8_t volatile PinListener::PendingMask[(NUM_DIGITAL_PINS + 7) / 8];
+bool volatile PinListener::AnyPending = false;
+PinListener::_Cursor *PinListener::Cursors = nullptr;
+bool EventClock::Pinned = false;
+uint32_t EventClock::PinnedMicros;
+SoftTimer *SoftTimer::Head = nullptr;
+Timers_one_for_all::TimerClass *SoftTimer::Hardware;
+std::move_only_function<void()> SoftTimer::TickCallback{ SoftTimer::_Tick };
+bool SoftTimer::InTick = false;
+uint32_t SoftTimer::LastMicros = 0;
+uint64_t SoftTimer::Epoch = 0;
+uint32_t SessionRandom::Source = 0;
+#ifdef GBEC_DEFER_TIMER_CONTINUATIONS
+RunQueue::_Ring RunQueue::Queues[RunQueue::NumPriorities];
+uint8_t RunQueue::HighWater = 0;
+uint16_t RunQueue::Overflows = 0;
+#endif
 Async_stream_IO::AsyncStream SerialStream;
 extern std::unordered_map<UID, uint16_t (*)(Process *)> SessionMap;
 static std::set<Process *> ExistingProcesses;
+static Async_stream_IO::Bitmap<255> ProcessHandles;
+uint16_t EventBatch::WindowMilliseconds = 10;
+uint8_t EventBatch::MaxRecords = GBEC_EVENT_BATCH_CAPACITY;
+uint16_t EventBatch::DroppedBatches = 0;
+EventBatch::Record EventBatch::Records[GBEC_EVENT_BATCH_CAPACITY];
+uint8_t EventBatch::Count = 0;
+uint32_t EventBatch::FirstMillis;
 UID const Delay<Infinite, Infinite>::ID = UID::Module_Delay;
 UID const _Sequential<>::ID = UID::Module_Sequential;
 
+#ifdef GBEC_COUNT_ALLOCATIONS
+#include <new>
+static volatile uint32_t AllocationCount = 0;
+_AllocationOwner _AllocationOwner::Current{};
+TimerIsrStatistics TimerIsrStatistics::Current{};
+uint8_t TimerIsrStatistics::Depth = 0;
+static void CountAllocation() {
+	++AllocationCount;
+	_AllocationOwner::Count();
+}
+// 必须替换核心库new.cpp中的全部变体，否则链接器会因其余变体再引入new.cpp而重复定义
+void *operator new(size_t Size) {
+	CountAllocation();
+	return malloc(Size);
+}
+void *operator new[](size_t Size) {
+	CountAllocation();
+	return malloc(Size);
+}
+void *operator new(size_t Size, std::nothrow_t const &) noexcept {
+	CountAllocation();
+	return malloc(Size);
+}
+void *operator new[](size_t Size, std::nothrow_t const &) noexcept {
+	CountAllocation();
+	return malloc(Size);
+}
+void operator delete(void *Pointer) noexcept {
+	free(Pointer);
+}
+void operator delete[](void *Pointer) noexcept {
+	free(Pointer);
+}
+void operator delete(void *Pointer, size_t) noexcept {
+	free(Pointer);
+}
+void operator delete[](void *Pointer, size_t) noexcept {
+	free(Pointer);
+}
+void operator delete(void *Pointer, std::nothrow_t const &) noexcept {
+	free(Pointer);
+}
+void operator delete[](void *Pointer, std::nothrow_t const &) noexcept {
+	free(Pointer);
+}
+#endif
+// PortA端口从0起连续编号至PortC_ProcessFinished之前。setup为每个PortA端口绑定一个监听器，它们必须都能放进监听器槽位，以下两个包装才可以不检查绑定结果
+static_assert(static_cast<uint8_t>(UID::PortC_ProcessFinished) <= ASYNC_STREAM_IO_LISTENER_SLOTS, "PortA端口数超出ASYNC_STREAM_IO_LISTENER_SLOTS，部分服务将无法绑定");
 template<typename T>
 inline void BindFunctionToPort(T &&Function, UID Port) {
-	SerialStream.BindFunctionToPort(std::forward<T>(Function), static_cast<Async_stream_IO::Port>(Port));
+	static_cast<void>(SerialStream.BindFunctionToPort(std::forward<T>(Function), static_cast<Async_stream_IO::Port>(Port)));
 }
 template<typename T>
 inline void SerialListen(T &&Callback, UID Port) {
-	SerialStream.Listen(std::forward<T>(Callback), static_cast<Async_stream_IO::Port>(Port));
+	static_cast<void>(SerialStream.Listen(std::forward<T>(Callback), static_cast<Async_stream_IO::Port>(Port)));
+}
+// 上电和回退时使用的波特率，必须与主机端AsyncSerialStream构造时的波特率一致
+constexpr uint32_t DefaultBaudRate = 9600;
+static uint32_t CurrentBaudRate = DefaultBaudRate;
+static uint32_t PreviousBaudRate;
+// 已应答主机、等待在loop中切换的波特率，0表示没有
+static uint32_t PendingBaudRate = 0;
+static uint16_t BaudRateTimeout;
+static uint32_t BaudRateDeadline;
+static bool BaudRateConfirming = false;
+static void SwitchBaudRate(uint32_t BaudRate) {
+	// 必须等应答等已缓冲的报文全部发出再切换，否则主机收不到
+	SerialStream.Flush();
+	Serial.flush();
+	Serial.end();
+	Serial.begin(BaudRate);
+	CurrentBaudRate = BaudRate;
+}
+// 在loop中执行波特率切换，并在主机未能在时限内以新波特率确认时回退
+// 波特率由时钟分频得到，实际波特率与请求值的误差超过2.5%时通信不可靠，不予切换。16MHz下常用的115200误差为2.1%，仍可接受
+static bool BaudRateSupported(uint32_t BaudRate) {
+	if (!BaudRate)
+		return false;
+#ifdef ARDUINO_ARCH_AVR
+	// 与HardwareSerial::begin相同：优先倍速模式，12位分频寄存器放不下时改用普通模式
+	uint32_t Divisor = (F_CPU / 4 / BaudRate - 1) / 2;
+	uint32_t Scale = 8;
+	if (Divisor > 4095) {
+		Divisor = (F_CPU / 8 / BaudRate - 1) / 2;
+		Scale = 16;
+	}
+	if (Divisor > 4095)
+		return false;
+	uint32_t const Actual = F_CPU / Scale / (Divisor + 1);
+#endif
+#ifdef ARDUINO_ARCH_SAM
+	// 与UARTClass::init相同：16位分频系数，截断取整
+	uint32_t const Divisor = SystemCoreClock / 16 / BaudRate;
+	if (!Divisor || Divisor > UINT16_MAX)
+		return false;
+	uint32_t const Actual = SystemCoreClock / 16 / Divisor;
+#endif
+	uint32_t const Error = Actual > BaudRate ? Actual - BaudRate : BaudRate - Actual;
+	return Error * 40 <= BaudRate;
+}
+static void CheckBaudRate() {
+	if (PendingBaudRate) {
+		PreviousBaudRate = CurrentBaudRate;
+		SwitchBaudRate(PendingBaudRate);
+		PendingBaudRate = 0;
+		BaudRateDeadline = millis() + BaudRateTimeout;
+		BaudRateConfirming = true;
+	} else if (BaudRateConfirming && static_cast<int32_t>(millis() - BaudRateDeadline) >= 0) {
+		SwitchBaudRate(PreviousBaudRate);
+		BaudRateConfirming = false;
+	}
 }
 bool CommonListenersHeader(Async_stream_IO::MessageSize &MessageSize, GbecHeader &Header) {
 	if (MessageSize < sizeof(Header))
@@ -39,8 +185,10 @@ bool CommonListenersHeader(Async_stream_IO::MessageSize &MessageSize, GbecHeader
 }
 
 void setup() {
-	Serial.begin(9600);
+	Serial.begin(DefaultBaudRate);
 	Serial.setTimeout(-1);
+	SerialStream.WaitingCallback = PinListener::ClearPending;
+	SoftTimer::Begin();
 	BindFunctionToPort([]() {
 		return static_cast<uint8_t>(sizeof(void const *));
 	},
@@ -49,13 +197,20 @@ void setup() {
 		return true;
 	},
 	                   UID::PortA_IsReady);
-#ifdef ARDUINO_ARCH_AVR
-	BindFunctionToPort(std::ArduinoUrng::seed,
+	BindFunctionToPort([](uint32_t Seed) {
+		SessionRandom::Source = Seed;
+		randomSeed(Seed);
+	},
 	                   UID::PortA_RandomSeed);
-#endif
 static Process* DebugPointer;
 	BindFunctionToPort([]() {
+		// 句柄用尽时拒绝创建，返回空指针。没有句柄的进程无法发出事件报文。
+		uint8_t const Handle = ProcessHandles.FindFirstZero();
+		if (Handle == 255)
+			return static_cast<Process *>(nullptr);
 		Process *P = new Process;
+		P->Handle = Handle;
+		ProcessHandles.Set(Handle);
 		ExistingProcesses.insert(P);
 		DebugPointer=P;
 		return P;
@@ -63,6 +218,7 @@ static Process* DebugPointer;
 	                   UID::PortA_CreateProcess);
 	BindFunctionToPort([](Process *P) {
 		if (ExistingProcesses.erase(P)) {
+			ProcessHandles.Reset(P->Handle);
 			delete P;
 			return UID::Exception_Success;
 		}
@@ -81,25 +237,41 @@ static Process* DebugPointer;
 			SerialStream.Send(UID::Exception_InvalidModule, Header.RemotePort);
 			return;
 		}
-		uint16_t Times;
+		// 可选参数依次为重复次数和随机种子，未指定种子时从种子源派生
+		uint16_t Times = 1;
+		uint32_t Seed;
 		switch (MessageSize) {
 			case 0:
-				Times = 1;
+				Seed = SessionRandom::NextSeed();
 				break;
 			case sizeof(uint16_t):
 				Times = SerialStream.Read<uint16_t>();
+				Seed = SessionRandom::NextSeed();
+				break;
+			case sizeof(uint32_t):
+				Seed = SerialStream.Read<uint32_t>();
+				break;
+			case sizeof(uint16_t) + sizeof(uint32_t):
+				Times = SerialStream.Read<uint16_t>();
+				Seed = SerialStream.Read<uint32_t>();
 				break;
 			default:
 				SerialStream.Skip(MessageSize);
 				SerialStream.Send(UID::Exception_BrokenStartArguments, Header.RemotePort);
 				return;
 		}
-		Header.P->TrialsDone.clear();
-		SerialStream.Send(ModuleStartReturn{ UID::Exception_Success, Iterator->second(Header.P) }, Header.RemotePort);
+		Header.P->Rng.seed(Seed);
+		uint16_t const NumTrials = Iterator->second(Header.P);
+		if (!Header.P->Loaded()) {
+			SerialStream.Send(UID::Exception_ModuleNotInLayout, Header.RemotePort);
+			return;
+		}
+		SerialStream.Send(ModuleStartReturn{ UID::Exception_Success, NumTrials }, Header.RemotePort);
 
-		if (!Header.P->Start(Times))
+		if (!Header.P->Start(Times)) {
+			EventBatch::Flush();
 			SerialStream.AsyncInvoke(static_cast<Async_stream_IO::Port>(UID::PortC_ProcessFinished), Header.P);
-
+		}
 	},
 	             UID::PortA_StartModule);
 	SerialListen([](Async_stream_IO::MessageSize MessageSize) {
@@ -113,21 +285,97 @@ static Process* DebugPointer;
 			SerialStream.Send(UID::Exception_InvalidModule, Header.RemotePort);
 			return;
 		}
-		MessageSize /= (sizeof(UID) + sizeof(uint16_t));
-		std::unordered_map<UID, uint16_t> &TrialsDone = Header.P->TrialsDone;
+		// 会话ID之后是1字节标志，非0表示其后附带中断时的随机种子和抽取次数，据此从中断处继续原来的随机序列；否则重新派生种子。然后是若干对回合ID和已完成次数。
+		bool const HasRandomState = MessageSize >= sizeof(uint8_t) && SerialStream.Read<uint8_t>();
+		Async_stream_IO::MessageSize const PrefixSize = sizeof(uint8_t) + (HasRandomState ? sizeof(uint32_t) * 2 : 0);
+		if (MessageSize < PrefixSize || (MessageSize - PrefixSize) % (sizeof(UID) + sizeof(uint16_t))) {
+			SerialStream.Skip(MessageSize ? MessageSize - sizeof(uint8_t) : 0);
+			SerialStream.Send(UID::Exception_BrokenRestoreArguments, Header.RemotePort);
+			return;
+		}
+		uint32_t RandomDraws = 0;
+		if (HasRandomState) {
+			Header.P->Rng.seed(SerialStream.Read<uint32_t>());
+			RandomDraws = SerialStream.Read<uint32_t>();
+		} else
+			Header.P->Rng.seed(SessionRandom::NextSeed());
+		MessageSize = (MessageSize - PrefixSize) / (sizeof(UID) + sizeof(uint16_t));
 
 		Iterator->second(Header.P);
-		//必须先载入模块，然后再设置TrialsDone，因为载入模块会清空TrialsDone
-		for (uint8_t i = 0; i < MessageSize; ++i) {
+		if (!Header.P->Loaded()) {
+			SerialStream.Skip(MessageSize * (sizeof(UID) + sizeof(uint16_t)));
+			SerialStream.Send(UID::Exception_ModuleNotInLayout, Header.RemotePort);
+			return;
+		}
+		// 模块构造时已抽取若干次，再补足到中断时的次数
+		Header.P->Rng.SkipTo(RandomDraws);
+		//必须先载入模块，然后再设置回合计数，因为载入模块会清零计数。不属于此会话的回合ID将被忽略。
+		for (Async_stream_IO::MessageSize i = 0; i < MessageSize; ++i) {
 			UID const TrialID = SerialStream.Read<UID>();
-			TrialsDone[TrialID] = SerialStream.Read<uint16_t>();
+			Header.P->SetTrialsDone(TrialID, SerialStream.Read<uint16_t>());
 		}
 
 		SerialStream.Send(UID::Exception_Success, Header.RemotePort);
-		if (!Header.P->Start(1))
+		if (!Header.P->Start(1)) {
+			EventBatch::Flush();
 			SerialStream.AsyncInvoke(static_cast<Async_stream_IO::Port>(UID::PortC_ProcessFinished), Header.P);
+		}
 	},
 	             UID::PortA_RestoreModule);
+	// 断点依次为随机种子、抽取次数和进程的执行路径，主机原样保存，恢复时原样发回
+	SerialListen([](Async_stream_IO::MessageSize MessageSize) {
+		GbecHeader Header;
+		if (CommonListenersHeader(MessageSize, Header))
+			return;
+		Checkpoint C;
+		{
+			Quick_digital_IO_interrupt::InterruptGuard const _;
+			C.Put(Header.P->Rng.Seed());
+			C.Put(Header.P->Rng.Draws());
+			Header.P->SaveCheckpoint(C);
+		}
+		if (C.Overflowed)
+			SerialStream.Send(UID::Exception_CheckpointOverflow, Header.RemotePort);
+		else
+			SerialStream.Send(C.Bytes, C.Size, Header.RemotePort);
+	},
+	             UID::PortA_GetCheckpoint);
+	SerialListen([](Async_stream_IO::MessageSize MessageSize) {
+		GbecHeader Header;
+		if (CommonListenersHeader(MessageSize, Header))
+			return;
+		auto const Iterator = SessionMap.find(SerialStream.Read<UID>());
+		MessageSize -= sizeof(UID);
+		if (Iterator == SessionMap.end()) {
+			SerialStream.Skip(MessageSize);
+			SerialStream.Send(UID::Exception_InvalidModule, Header.RemotePort);
+			return;
+		}
+		if (MessageSize < Checkpoint::HeaderBytes || MessageSize > GBEC_CHECKPOINT_CAPACITY) {
+			SerialStream.Skip(MessageSize);
+			SerialStream.Send(UID::Exception_BrokenRestoreArguments, Header.RemotePort);
+			return;
+		}
+		Checkpoint C;
+		while (C.Size < MessageSize)
+			C.Bytes[C.Size++] = SerialStream.Read<uint8_t>();
+		Header.P->Rng.seed(C.Get<uint32_t>());
+		uint32_t const RandomDraws = C.Get<uint32_t>();
+		// 载入模块会清零回合计数，此处有意不恢复：断点已记录各容器的剩余次数和位置，不需要跳过回合；若仍设置计数，断点之后的回合反而会被误跳过
+		Iterator->second(Header.P);
+		if (!Header.P->Loaded()) {
+			SerialStream.Send(UID::Exception_ModuleNotInLayout, Header.RemotePort);
+			return;
+		}
+		Header.P->Rng.SkipTo(RandomDraws);
+
+		SerialStream.Send(UID::Exception_Success, Header.RemotePort);
+		if (!Header.P->StartFrom(C)) {
+			EventBatch::Flush();
+			SerialStream.AsyncInvoke(static_cast<Async_stream_IO::Port>(UID::PortC_ProcessFinished), Header.P);
+		}
+	},
+	             UID::PortA_RestoreCheckpoint);
 	BindFunctionToPort([](Process *P) {
 		if (ExistingProcesses.contains(P)) {
 			P->Pause();
@@ -162,7 +410,7 @@ static Process* DebugPointer;
 	SerialListen([](Async_stream_IO::MessageSize MessageSize) {
 		if (MessageSize < sizeof(Async_stream_IO::Port))
 			return;
-		Async_stream_IO::InterruptGuard const Token = SerialStream.BeginSend(sizeof(Process *) * ExistingProcesses.size(), SerialStream.Read<Async_stream_IO::Port>());
+		Async_stream_IO::AsyncStream::SendSession const Token = SerialStream.BeginSend(sizeof(Process *) * ExistingProcesses.size(), SerialStream.Read<Async_stream_IO::Port>());
 		for (Process *const P : ExistingProcesses)
 			SerialStream << P;
 	},
@@ -171,10 +419,86 @@ static Process* DebugPointer;
 		return ExistingProcesses.contains(P);
 	},
 	                   UID::PortA_ProcessValid);
+	BindFunctionToPort([](Process *P) {
+		return ExistingProcesses.contains(P) ? P->Handle : std::numeric_limits<uint8_t>::max();
+	},
+	                   UID::PortA_ProcessHandle);
+	BindFunctionToPort([]() {
+		Quick_digital_IO_interrupt::InterruptGuard const _;
+		return StreamStatisticsReturn{ SerialStream.Statistics(), EventBatch::DroppedBatches };
+	},
+	                   UID::PortA_StreamStatistics);
+	BindFunctionToPort([](uint32_t BaudRate, uint16_t TimeoutMilliseconds) {
+		if (!BaudRateSupported(BaudRate) || PendingBaudRate || BaudRateConfirming)
+			return UID::Exception_InvalidBaudRate;
+		PendingBaudRate = BaudRate;
+		BaudRateTimeout = TimeoutMilliseconds;
+		return UID::Exception_Success;
+	},
+	                   UID::PortA_SetBaudRate);
+	BindFunctionToPort([]() {
+		BaudRateConfirming = false;
+		return CurrentBaudRate;
+	},
+	                   UID::PortA_ConfirmBaudRate);
+	BindFunctionToPort([]() {
+#ifdef GBEC_COUNT_ALLOCATIONS
+		Quick_digital_IO_interrupt::InterruptGuard const _;
+		return static_cast<uint32_t>(AllocationCount);
+#else
+		// 未插桩
+		return std::numeric_limits<uint32_t>::max();
+#endif
+	},
+	                   UID::PortA_AllocationCount);
+	BindFunctionToPort([](Process *P, uint8_t Index) {
+#ifdef GBEC_COUNT_ALLOCATIONS
+		if (!ExistingProcesses.contains(P))
+			return ModuleAllocationReturn{ UID::Exception_InvalidProcess };
+		ModuleAllocationReturn Return;
+		Quick_digital_IO_interrupt::InterruptGuard const _;
+		UID const *const ID = P->ModuleAllocation(Index, Return.Load, Return.Run);
+		Return.Module = ID ? *ID : UID::Exception_InvalidModule;
+		return Return;
+#else
+		return ModuleAllocationReturn{ UID::Exception_MethodNotImplemented };
+#endif
+	},
+	                   UID::PortA_ModuleAllocations);
+	BindFunctionToPort([]() {
+		TimerStatisticsReturn Return{ std::numeric_limits<uint32_t>::max() };
+		Quick_digital_IO_interrupt::InterruptGuard const _;
+#ifdef GBEC_COUNT_ALLOCATIONS
+		Return.IsrCount = TimerIsrStatistics::Current.Count;
+		Return.IsrTotalMicros = TimerIsrStatistics::Current.TotalMicros;
+		Return.IsrMaxMicros = TimerIsrStatistics::Current.MaxMicros;
+#endif
+#ifdef GBEC_DEFER_TIMER_CONTINUATIONS
+		Return.QueueCapacity = GBEC_RUN_QUEUE_CAPACITY;
+		Return.QueueHighWater = RunQueue::HighWater;
+		Return.QueueOverflows = RunQueue::Overflows;
+#endif
+		return Return;
+	},
+	                   UID::PortA_TimerStatistics);
+	BindFunctionToPort([](uint16_t WindowMilliseconds, uint8_t MaxRecords) {
+		if (!MaxRecords || MaxRecords > GBEC_EVENT_BATCH_CAPACITY)
+			return UID::Exception_InvalidEventBatch;
+		EventBatch::Flush();
+		EventBatch::WindowMilliseconds = WindowMilliseconds;
+		EventBatch::MaxRecords = MaxRecords;
+		return UID::Exception_Success;
+	},
+	                   UID::PortA_SetEventBatch);
 	SerialStream.Send(nullptr, 0, static_cast<Async_stream_IO::Port>(UID::PortC_ImReady));
 }
 void loop() {
 	PinListener::ClearPending();
+#ifdef GBEC_DEFER_TIMER_CONTINUATIONS
+	RunQueue::Drain();
+#endif
+	EventBatch::Poll();
 	SerialStream.ExecuteTransactionsInQueue();
+	CheckBaudRate();
 }
 #include <TimersOneForAll_Define.hpp>
\ No newline at end of file
@@ -1,1477 +1,3068 @@
-#pragma once
-#include "UID.hpp"
-#include "Async_stream_IO.hpp"
-#include "Timers_one_for_all.hpp"
-#include <Quick_digital_IO_interrupt.hpp>
-#include <map>
-#include <random>
-#include <sstream>
-#include <functional>
-#include <queue>
-#include <set>
-#include <iterator>
-using namespace std::chrono_literals;
-using DurationRep = uint32_t;
-struct PinListener {
-	uint8_t const Pin;
-	std::shared_ptr<std::move_only_function<void()>> const Callback;
-
-	// 中断不安全
-	void Pause() const {
-		auto& CallbackSet = PinStates[Pin].CallbackSet;
-
-		CallbackSet.erase(Callback);
-		//必须先erase再检测空，不能检测到剩1就直接全删，因为Callback有可能不匹配
-		if (CallbackSet.empty()) {
-			Quick_digital_IO_interrupt::DetachInterrupt(Pin);
-
-			//高频调用在ClearPending处，优先优化它，减少迭代次数，因此这里擦除空Pin是合适的
-			PinStates.erase(Pin);
-		}
-	}
-
-	// 中断不安全
-	void Continue() const {
-		auto& CallbackSet = PinStates[Pin].CallbackSet;
-		if (CallbackSet.empty())
-			Quick_digital_IO_interrupt::AttachInterrupt<RISING>(Pin, PinInterrupt{ Pin });
-		CallbackSet.insert(Callback);
-	}
-
-	// 中断不安全
-	~PinListener() {
-		Pause();
-	}
-
-	// 中断安全
-	static void ClearPending() {
-
-		Quick_digital_IO_interrupt::InterruptGuard const _;
-		//此函数必须全程禁用中断，否则引脚中断和计时器中断可能打断Callback导致全局状态异常
-
-		for (auto& Iterator : PinStates) {
-			PinState& PS = Iterator.second;
-			if (PS.Pending) {
-				PS.Pending = false;
-				for (auto const& Callback : PS.CallbackSet)
-					if (auto CallbackPtr = Callback.lock())
-						(*CallbackPtr)();
-					else
-						PS.CallbackSet.erase(Callback);
-				Quick_digital_IO_interrupt::AttachInterrupt<RISING>(Iterator.first, PinInterrupt{ Iterator.first });
-			}
-		}
-	}
-
-protected:
-	class PinState {
-		using FunctionPointer = std::weak_ptr<std::move_only_function<void()>>;
-	public:
-		bool Pending = false;
-		std::set<FunctionPointer, std::owner_less<FunctionPointer>> CallbackSet;
-	};
-	static std::map<uint8_t, PinState> PinStates;
-
-	/*无需记住Callback，只需根据Pin从全局列表中检索并转移Callback。每个引脚对应的Callback列表需要对全局ClearPending可见，因此不能被任何单个对象私有。
-	此对象只有一个字节，通常直接传值即可，无需考虑拷贝开销。
-	*/
-	struct PinInterrupt {
-		uint8_t const Pin;  //Pin不能是模板参数：需要接受运行时值
-
-		//此函数被引脚中断调用，因此中断安全
-		void operator()() const {
-			PinStates[Pin].Pending = true;
-			Quick_digital_IO_interrupt::DetachInterrupt(Pin);
-		}
-	};
-};
-
-inline static void InfoWrite(std::ostringstream& InfoStream, UID InfoValue) {
-	InfoStream.put(static_cast<char>(InfoValue));
-}
-inline static void InfoWrite(std::ostringstream& InfoStream, uint8_t InfoValue) {
-	InfoStream.put(static_cast<char>(InfoValue));
-}
-template<typename T>
-inline static void InfoWrite(std::ostringstream& InfoStream, T InfoValue) {
-	InfoStream.write(reinterpret_cast<const char*>(&InfoValue), sizeof(InfoValue));
-}
-// 强制要求2个以上输入，以免递归
-template<typename T1, typename T2, typename... T>
-inline static void InfoWrite(std::ostringstream& InfoStream, T1 InfoValue1, T2 InfoValue2, T... InfoValues) {
-	int _[] = { (InfoWrite(InfoStream, InfoValue1), 0), (InfoWrite(InfoStream, InfoValue2), 0), (InfoWrite(InfoStream, InfoValues), 0)... };
-}
-extern Async_stream_IO::AsyncStream SerialStream;
-
-template<typename Target>
-struct _ModuleID {
-	static UID const& ID;
-};
-struct Process;
-struct IInformative {
-	virtual void WriteInfo() const = 0;
-	// 使用函数而非成员变量以节省运行内存
-	virtual Async_stream_IO::MessageSize InfoSize() const = 0;
-	virtual ~IInformative() = default;
-};
-// 所有模块的基类，本身可以当作一个什么都不做的空模块使用
-struct Module : IInformative {
-	Process& Container;
-	constexpr Module(Process& Container)
-		: Container(Container) {
-	}
-	// 返回是否需要等待回调，并提供回调函数。返回true表示模块还在执行中，将在执行完毕后调用回调函数；返回false表示模块已执行完毕，不会调用回调函数。
-	virtual bool Start(std::move_only_function<void()>& FinishCallback) {
-		return false;
-	}
-	// 放弃该模块。未在执行的步骤放弃也不会出错。但不会调用FinishCallback。
-	virtual void Abort() {}
-
-	// 重新开始当前执行中的步骤，不改变下一步。重启已结束的模块，本次执行结束后也会继续调用上次Start设置的下一步。
-	virtual void Restart() {}
-
-	// 注意模块析构时不Abort。模块的Abort只由ModuleAbort步骤负责调用。
-	static constexpr uint16_t NumTrials = 0;
-
-protected:
-	static std::move_only_function<void()> _EmptyCallback;
-	struct _EmptyStart {
-		Module* const ContentModule;
-		void operator()() const {
-			ContentModule->Start(_EmptyCallback);
-		}
-	};
-};
-
-// 仅在LoadModule时用作重载提示，无定义
-template<UID ID>
-struct IDModule;
-template<typename M>
-struct _IDModule {
-	using type = M;
-};
-template<typename M>
-using _IDModule_t = typename _IDModule<M>::type;
-
-template<typename T>
-struct _TypeID {
-	static constexpr UID value = UID::Type_Pointer;
-};
-template<>
-struct _TypeID<std::chrono::seconds> {
-	static constexpr UID value = UID::Type_Seconds;
-};
-template<>
-struct _TypeID<std::chrono::milliseconds> {
-	static constexpr UID value = UID::Type_Milliseconds;
-};
-template<>
-struct _TypeID<std::chrono::microseconds> {
-	static constexpr UID value = UID::Type_Microseconds;
-};
-template<>
-struct _TypeID<UID> {
-	static constexpr UID value = UID::Type_UID;
-};
-template<>
-struct _TypeID<uint8_t> {
-	static constexpr UID value = UID::Type_UInt8;
-};
-template<>
-struct _TypeID<uint16_t> {
-	static constexpr UID value = UID::Type_UInt16;
-};
-template<>
-struct _TypeID<uint32_t> {
-	static constexpr UID value = UID::Type_UInt32;
-};
-template<>
-struct _TypeID<bool> {
-	static constexpr UID value = UID::Type_Bool;
-};
-#pragma pack(push, 1)
-template<typename T>
-struct PodField {
-	UID const FieldName;
-	UID const FieldType;
-	T FieldValue;
-	constexpr PodField(UID FieldName, T FieldValue)
-		: FieldName(FieldName), FieldType(_TypeID<T>::value), FieldValue(FieldValue) {
-	}
-	constexpr PodField(UID FieldName, UID FieldType, T FieldValue)
-		: FieldName(FieldName), FieldType(FieldType), FieldValue(FieldValue) {
-	}
-};
-#pragma pack(pop)
-class Process {
-	Async_stream_IO::MessageSize InfoSize;
-	std::set<Timers_one_for_all::TimerClass*> ActiveTimers;
-	std::map<UID const*, std::unique_ptr<IInformative>> Modules;
-	uint16_t TimesLeft;
-	UID const* StartPointer;
-#pragma pack(push, 1)
-	struct InfoHeader {
-		uint8_t const NumFields = 2;
-		PodField<UID const*> StartModule;
-		UID const Field2Name = UID::Field_Modules;
-		UID const Field2Type = UID::Type_Map;
-		uint8_t NumModules;
-		UID const ModuleKeyType = UID::Type_Pointer;
-		UID const ModuleValueType = UID::Type_Struct;
-		constexpr InfoHeader(UID const* StartPointer, uint8_t NumModules)
-			: StartModule{ UID::Field_StartModule, StartPointer }, NumModules(NumModules) {
-		}
-	};
-#pragma pack(pop)
-	std::move_only_function<void()> FinishCallback{
-		[this]() {
-		  while (--TimesLeft)
-			  // 基类指针转派生，不能用reinterpret_cast
-			  if (static_cast<Module*>(Modules[StartPointer].get())->Start(FinishCallback))
-				  return;
-		  SerialStream.AsyncInvoke(static_cast<Async_stream_IO::Port>(UID::PortC_ProcessFinished), this);
-		}
-	};
-
-	// 中断不安全
-	void _Abort() {
-		for (PinListener const* H : ActiveInterrupts)
-			H->Pause();
-		for (Timers_one_for_all::TimerClass* T : ActiveTimers) {
-			T->Stop();
-			T->Allocatable = true;  // 使其可以被重新分配
-		}
-		for (std::move_only_function<void()>* Cleaner : ExtraCleaners)
-			(*Cleaner)();
-	}
-	template<typename T>
-	auto Construct(T* At) -> decltype(new (At) T(*this)) {
-		new (At) T(*this);
-	}
-	template<typename T>
-	static auto Construct(T* At) -> decltype(new (At) T()) {
-		new (At) T;
-	}
-
-public:
-	std::set<PinListener const*> ActiveInterrupts;
-	void Pause() const {
-		for (PinListener const* H : ActiveInterrupts)
-			H->Pause();
-		for (Timers_one_for_all::TimerClass* T : ActiveTimers)
-			T->Pause();
-	}
-	void Continue() const {
-		for (PinListener const* H : ActiveInterrupts)
-			H->Continue();
-		for (Timers_one_for_all::TimerClass* T : ActiveTimers)
-			T->Continue();
-	}
-	void Abort() {
-		_Abort();
-		ActiveInterrupts.clear();
-		ActiveTimers.clear();
-		TrialsDone.clear();
-		ExtraCleaners.clear();
-	}
-	virtual ~Process() {
-		_Abort();
-	}
-	Timers_one_for_all::TimerClass* AllocateTimer() {
-		Timers_one_for_all::TimerClass* Timer = Timers_one_for_all::AllocateTimer();
-		ActiveTimers.insert(Timer);
-		return Timer;
-	}
-	// 此操作不负责停止计时器，仅使其可以被再分配
-	void UnregisterTimer(Timers_one_for_all::TimerClass* Timer) {
-		ActiveTimers.erase(Timer);
-		Timer->Allocatable = true;
-	}
-	template<typename ModuleType>
-	_IDModule_t<ModuleType>* LoadModule() {
-		using _ModuleType = _IDModule_t<ModuleType>;
-		auto const Iter = Modules.find(&_ModuleID<_ModuleType>::ID);
-		if (Iter != Modules.end())
-			return static_cast<_ModuleType*>(Iter->second.get());
-		_ModuleType* const RawMemory = static_cast<_ModuleType*>(operator new(sizeof(_ModuleType)));
-
-		Modules.emplace(&_ModuleID<_ModuleType>::ID, std::unique_ptr<IInformative>(RawMemory));
-		//必须先占位后构造，以免递归构造自身
-		Construct(RawMemory);
-
-		InfoSize += RawMemory->InfoSize() + sizeof(decltype(Modules)::key_type);
-		return RawMemory;
-	}
-
-	// 此方法会终止并清空当前执行的所有模块（通过清理资源的方法，不调用模块Abort，但会调用清理模块），然后再开始新的模块
-	template<typename Entry>
-	uint16_t LoadStartModule() {
-
-		using _Entry = _IDModule_t<Entry>;
-		Abort();
-		Modules.clear();
-		InfoSize = sizeof(InfoHeader);
-		StartPointer = &_ModuleID<_Entry>::ID;
-		LoadModule<_Entry>();
-		return _Entry::NumTrials;
-	}
-
-	bool Start(uint16_t Times) {
-
-		for (TimesLeft = Times; TimesLeft > 0; --TimesLeft) {
-			if (static_cast<Module*>(Modules[StartPointer].get())->Start(FinishCallback))
-				return true;
-		}
-		return false;
-	}
-	// 发送当前或上一个执行模块及其关联模块的所有信息
-	void SendInfo(Async_stream_IO::Port Port) const {
-		Async_stream_IO::InterruptGuard const _ = SerialStream.BeginSend(InfoSize, Port);
-		SerialStream << InfoHeader(StartPointer, Modules.size());
-		for (auto const& Iterator : Modules) {
-			SerialStream << Iterator.first;
-			Iterator.second->WriteInfo();
-		}
-	}
-	std::unordered_map<UID, uint16_t> TrialsDone;
-	std::set<std::move_only_function<void()>*> ExtraCleaners;
-};
-struct IRandom {
-	virtual void Randomize() = 0;
-};
-
-template<uint16_t...>
-struct _Sum {
-	static constexpr uint16_t value = 0;
-};
-template<uint16_t First, uint16_t... Rest>
-struct _Sum<First, Rest...> {
-	static constexpr uint16_t value = First + _Sum<Rest...>::value;
-};
-
-#define InfoImplement \
-	static UID const ID; \
-	void WriteInfo() const override { \
-		SerialStream << InfoStruct{}; \
-	} \
-	Async_stream_IO::MessageSize InfoSize() const override { \
-		return sizeof(InfoStruct); \
-	}
-struct OneTimeFC {
-protected:
-	std::move_only_function<void()>* FinishCallback;
-	//防止Skip重复调用或未运行就Skip，FinishCallback必须调完即弃。FinishCallback的可用性必须由调用方负责检查。
-	void FcAndDiscard() {
-		std::move_only_function<void()>& FC = *FinishCallback;
-		FinishCallback = nullptr;
-		FC();
-	}
-};
-template<typename... SubModules>
-struct RandomSequential : Module, IRandom, OneTimeFC {
-protected:
-	static constexpr
-#ifdef ARDUINO_ARCH_AVR
-		std::ArduinoUrng
-#endif
-#ifdef ARDUINO_ARCH_SAM
-		std::TrueUrng
-#endif
-		Urng{};
-#pragma pack(push, 1)
-	struct InfoStruct {
-		uint8_t const NumFields = 2;
-		PodField<UID> const ID{ UID::Field_ID, _ModuleID<RandomSequential>::ID };
-		UID const Field2Name = UID::Field_Modules;
-		UID const Field2Type = UID::Type_Array;
-		uint8_t const NumModules{ sizeof...(SubModules) };
-		UID const ModuleType = UID::Type_Pointer;
-		UID const* const ModuleValues[sizeof...(SubModules)] = { &_ModuleID<_IDModule_t<SubModules>>::ID... };
-	};
-#pragma pack(pop)
-	Module* SubPointers[sizeof...(SubModules)] = { Module::Container.LoadModule<_IDModule_t<SubModules>>()... };  // SAM编译器不能自动推断数组长度，导致cend不可用
-	Module* const* CurrentModule = std::cend(SubPointers);
-	std::move_only_function<void()> NextBlock;
-
-public:
-	template<uint16_t... Repeats>
-	struct WithRepeat : Module, IRandom, OneTimeFC {
-	protected:
-#pragma pack(push, 1)
-		struct InfoStruct {
-			uint8_t const NumFields = 2;
-			PodField<UID> const ID{ UID::Field_ID, _ModuleID<WithRepeat>::ID };
-			UID const Field2Name = UID::Field_Modules;
-			UID const Field2Type = UID::Type_Table;
-			uint8_t const NumModules{ sizeof...(SubModules) };
-			uint8_t const NumColumns = 2;
-			UID const Column1Name = UID::Column_Module;
-			UID const Column1Type = UID::Type_Pointer;
-			UID const* const Column1Values[sizeof...(SubModules)] = { &_ModuleID<_IDModule_t<SubModules>>::ID... };
-			UID const Column2Name = UID::Column_Repeats;
-			UID const Column2Type = UID::Type_UInt16;
-			uint16_t const Column2Values[sizeof...(SubModules)];
-			constexpr InfoStruct()
-				: Column2Values{ Repeats... } {
-			}
-		};
-#pragma pack(pop)
-		Module* SubPointers[_Sum<Repeats...>::value];
-		Module** CurrentModule = std::begin(SubPointers);  //必须设为begin；因为构造函数中要用到
-		std::move_only_function<void()> NextBlock;         // 不能在此处等号初始化，SAM会编译器错误
-	public:
-		void Randomize() override {
-			std::shuffle(std::begin(SubPointers), std::end(SubPointers), Urng);
-		}
-		WithRepeat(Process& Container)
-			: Module(Container), NextBlock{ [this]() {  //初始化NextBlock，主要是为了防止直接Restart时NextBlock未定义。
-				  while (++CurrentModule < std::end(SubPointers))
-					  if ((*CurrentModule)->Start(NextBlock))
-						  return;
-				} } {
-			Module** _[] = { (CurrentModule = std::fill_n(CurrentModule, Repeats, Module::Container.LoadModule<_IDModule_t<SubModules>>()))... };
-			//自此CurrentModule变为end位置，正好表示未在运行
-			Randomize();
-		}
-		void Abort() override {
-			if (CurrentModule < std::end(SubPointers)) {
-				(*CurrentModule)->Abort();
-				FinishCallback = nullptr;
-			}
-		}
-		void Skip() {
-			if (CurrentModule < std::end(SubPointers)) {
-				(*CurrentModule)->Abort();
-				if (FinishCallback)  //被Restart启动的运行状态，FinishCallback可能为空
-					FcAndDiscard();
-			}
-		}
-		void Restart() override {
-			Abort();
-			for (CurrentModule = std::begin(SubPointers); CurrentModule < std::end(SubPointers); ++CurrentModule)
-				if ((*CurrentModule)->Start(NextBlock))
-					return;
-		}
-		bool Start(std::move_only_function<void()>& FC) override {
-			Abort();
-			FinishCallback = &FC;
-			for (CurrentModule = std::begin(SubPointers); CurrentModule < std::end(SubPointers); ++CurrentModule)
-				if ((*CurrentModule)->Start(NextBlock)) {
-					NextBlock = [this]() {
-						while (++CurrentModule < std::end(SubPointers))
-							if ((*CurrentModule)->Start(NextBlock))
-								return;
-						FcAndDiscard();
-						};
-					return true;
-				}
-			return false;
-		}
-		static constexpr uint16_t NumTrials = _Sum<_IDModule_t<SubModules>::NumTrials * Repeats...>::value;
-		InfoImplement;
-	};
-	void Randomize() override {
-		std::shuffle(std::begin(SubPointers), std::end(SubPointers), Urng);
-	}
-	RandomSequential(Process& Container)
-		: Module(Container), NextBlock{ [this]() {
-			  while (++CurrentModule < std::cend(SubPointers))
-				  if ((*CurrentModule)->Start(NextBlock))
-					  return;
-			} } {
-		Randomize();
-	}
-	void Abort() override {
-		if (CurrentModule < std::cend(SubPointers)) {
-			(*CurrentModule)->Abort();
-			FinishCallback = nullptr;
-		}
-	}
-	void Restart() override {
-		Abort();
-		for (CurrentModule = std::cbegin(SubPointers); CurrentModule < std::cend(SubPointers); ++CurrentModule)
-			if ((*CurrentModule)->Start(NextBlock))
-				return;
-	}
-	bool Start(std::move_only_function<void()>& FC) override {
-		Abort();
-		FinishCallback = &FC;
-		for (CurrentModule = std::cbegin(SubPointers); CurrentModule < std::cend(SubPointers); ++CurrentModule)
-			if ((*CurrentModule)->Start(NextBlock)) {
-				NextBlock = [this, &FC]() {
-					while (++CurrentModule < std::cend(SubPointers))
-						if ((*CurrentModule)->Start(NextBlock))
-							return;
-					FcAndDiscard();
-					};
-				return true;
-			}
-		return false;
-	}
-	static constexpr uint16_t NumTrials = _Sum<_IDModule_t<SubModules>::NumTrials...>::value;
-	InfoImplement;
-};
-template<typename... SubModules>
-UID const RandomSequential<SubModules...>::ID = UID::Module_RandomSequential;
-template<typename... SubModules>
-template<uint16_t... Repeats>
-UID const RandomSequential<SubModules...>::WithRepeat<Repeats...>::ID = UID::Module_RandomSequential;
-// 表示一个固定整数
-template<DurationRep Value>
-struct ConstantInteger : IInformative {
-protected:
-#pragma pack(push, 1)
-	struct InfoStruct {
-		uint8_t const NumFields = 2;
-		PodField<UID> const ID{ UID::Field_ID, UID::Module_ConstantInteger };
-		PodField<DurationRep> const ValueField{ UID::Field_Value, Value };
-	};
-#pragma pack(pop)
-public:
-	static constexpr uint16_t NumTrials = Value;
-	constexpr DurationRep Current() const {
-		return Value;
-	}
-	InfoImplement;
-};
-template<DurationRep Value>
-UID const ConstantInteger<Value>::ID = UID::Module_ConstantInteger;
-// 表示一个随机整数。该步骤维护一个随机变量，只有使用Randomize步骤才能改变这个变量，否则一直保持相同的值。如果有多个随机范围相同的随机变量需要独立控制随机性，可以指定不同的ID，否则视为同一个随机变量。
-template<DurationRep Min, DurationRep Max, UID CustomID = UID::Module_RandomInteger>
-struct RandomInteger : IInformative, IRandom {
-protected:
-#pragma pack(push, 1)
-	struct InfoStruct {
-		uint8_t const NumFields = 2;
-		PodField<UID> const ID{ UID::Field_ID, CustomID };
-		UID const Field2Name = UID::Field_Range;
-		UID const Field2Type = UID::Type_Array;
-		uint8_t const NumElements = 2;
-		UID const ElementType = _TypeID<DurationRep>::value;
-		DurationRep const MinValue = Min;
-		DurationRep const MaxValue = Max;
-	};
-#pragma pack(pop)
-	DurationRep _Current;
-
-public:
-	RandomInteger() {
-		Randomize();
-	}
-	void Randomize() {
-		constexpr double DoubleMin = Min;
-		_Current = static_cast<DurationRep>(pow(static_cast<double>(Max) / DoubleMin, static_cast<double>(random(__LONG_MAX__)) / (__LONG_MAX__ - 1)) * DoubleMin);
-	}
-	static constexpr uint16_t NumTrials = 0;
-	DurationRep Current() const {
-		return _Current;
-	}
-	InfoImplement;
-};
-template<DurationRep Min, DurationRep Max, UID CustomID>
-UID const RandomInteger<Min, Max, CustomID>::ID = CustomID;
-using Infinite = void;
-// 无限重复模块，也可以额外指定UntilTimes重复次数。不能指定重复时间，请组合使用 Async Delay ModuleAbort 等模块实现。
-template<typename Content, typename Times = Infinite>
-struct Repeat : Module {
-protected:
-	uint16_t TimesLeft;
-	Times const* const T;
-#pragma pack(push, 1)
-	struct InfoStruct {
-		uint8_t const NumFields = 3;
-		PodField<UID> const ID{ UID::Field_ID, _ModuleID<Repeat>::ID };
-		PodField<UID const*> const ContentField{ UID::Field_Content, &_ModuleID<_IDModule_t<Content>>::ID };
-		PodField<UID const*> const TimesField{ UID::Field_Times, &_ModuleID<Times>::ID };
-	};
-#pragma pack(pop)
-	_IDModule_t<Content>* const ContentPtr = Module::Container.LoadModule<Content>();
-	std::move_only_function<void()> NextBlock;
-
-public:
-	Repeat(Process& Container)
-		: Module(Container), NextBlock{ [this]() {
-			  while (--TimesLeft)
-				  if (ContentPtr->Start(NextBlock))
-					  return;
-			} },
-		T{ Module::Container.LoadModule<Times>() } {
-	}
-	void Restart() override {
-		Abort();
-		for (TimesLeft = T->Current(); TimesLeft; --TimesLeft)
-			if (ContentPtr->Start(NextBlock))
-				return;
-	}
-	bool Start(std::move_only_function<void()>& FC) override {
-		Abort();
-		for (TimesLeft = T->Current(); TimesLeft; --TimesLeft)
-			if (ContentPtr->Start(NextBlock)) {
-				NextBlock = [this, &FC]() {
-					while (--TimesLeft)
-						if (ContentPtr->Start(NextBlock))
-							return;
-					FC();
-					};
-				return true;
-			}
-		return false;
-	}
-	static constexpr uint16_t NumTrials = _IDModule_t<Content>::NumTrials * Times::NumTrials;
-	InfoImplement;
-};
-template<typename Content, typename Times>
-UID const Repeat<Content, Times>::ID = UID::Module_Repeat;
-template<typename Content>
-struct Repeat<Content, Infinite> : Module {
-protected:
-#pragma pack(push, 1)
-	struct InfoStruct {
-		uint8_t const NumFields = 2;
-		PodField<UID> const ID{ UID::Field_ID, _ModuleID<Repeat>::ID };
-		PodField<UID const*> const ContentField{ UID::Field_Content, &_ModuleID<_IDModule_t<Content>>::ID };
-	};
-#pragma pack(pop)
-	_IDModule_t<Content>* const ContentPtr = Module::Container.LoadModule<Content>();
-	std::move_only_function<void()> NextBlock;
-public:
-	Repeat(Process& Container)
-		: Module(Container), NextBlock{ [this]() {
-			  for (;;)
-				  if (ContentPtr->Start(NextBlock))
-					  return;
-			} } {
-	}
-	void Abort() override {
-		ContentPtr->Abort();
-	}
-	void Restart() override {
-		ContentPtr->Abort();
-		NextBlock();
-	}
-	bool Start(std::move_only_function<void()>& FC) override {
-		Abort();
-		for (;;)
-			if (ContentPtr->Start(NextBlock))
-				return true;
-		return false;
-	}
-	static constexpr uint16_t NumTrials = _IDModule_t<Content>::NumTrials;
-	InfoImplement;
-};
-template<typename Content>
-UID const Repeat<Content, Infinite>::ID = UID::Module_Repeat;
-template<typename... SubModules>
-struct _Sequential : Module {
-protected:
-	Module* const SubPointers[sizeof...(SubModules)] = { Module::Container.LoadModule<SubModules>()... };
-	Module* const* CurrentModule = std::cend(SubPointers);
-
-	// 必须预设NextBlock，这样即使没有Start直接Restart也能执行完整个模块
-	std::move_only_function<void()> NextBlock;
-#pragma pack(push, 1)
-	struct InfoStruct {
-		uint8_t const NumFields = 2;
-		PodField<UID> const ID{ UID::Field_ID, _ModuleID<_Sequential>::ID };
-		UID const Field2Name = UID::Field_Modules;
-		UID const Field2Type = UID::Type_Array;
-		uint8_t const NumModules{ sizeof...(SubModules) };
-		UID const ModuleType = UID::Type_Pointer;
-		UID const* const ModuleValues[sizeof...(SubModules)] = { &_ModuleID<_IDModule_t<SubModules>>::ID... };
-	};
-#pragma pack(pop)
-public:
-	_Sequential(Process& Container)
-		: Module(Container), NextBlock{ [this]() {
-			  while (++CurrentModule < std::cend(SubPointers))
-				  if ((*CurrentModule)->Start(NextBlock))
-					  return;
-			} } {
-	}
-	void Abort() override {
-		if (CurrentModule < std::cend(SubPointers))
-			(*CurrentModule)->Abort();
-	}
-	void Restart() override {
-		Abort();
-		for (CurrentModule = std::cbegin(SubPointers); CurrentModule < std::cend(SubPointers); ++CurrentModule)
-			if ((*CurrentModule)->Start(NextBlock))
-				return;
-	}
-	bool Start(std::move_only_function<void()>& FC) override {
-		Abort();
-		for (CurrentModule = std::cbegin(SubPointers); CurrentModule < std::cend(SubPointers); ++CurrentModule) {
-			if ((*CurrentModule)->Start(NextBlock)) {
-				NextBlock = [this, &FC]() {
-					while (++CurrentModule < std::cend(SubPointers))
-						if ((*CurrentModule)->Start(NextBlock))
-							return;
-					FC();
-					};
-				return true;
-			}
-		}
-		return false;
-	}
-	static constexpr uint16_t NumTrials = _Sum<_IDModule_t<SubModules>::NumTrials...>::value;
-	InfoImplement;
-};
-template<>
-struct _Sequential<> : Module {
-protected:
-#pragma pack(push, 1)
-	struct InfoStruct {
-		uint8_t const NumFields = 0;
-	};
-#pragma pack(pop)
-public:
-	_Sequential(Process& Container)
-		: Module(Container) {
-	}
-	static constexpr uint16_t NumTrials = 0;
-	InfoImplement;
-};
-template<typename... SubModules>
-UID const _Sequential<SubModules...>::ID = UID::Module_Sequential;
-
-namespace detail {
-	template<typename... Ts>
-	struct type_list {
-	};
-
-	template<typename A, typename B>
-	struct concat;
-	template<typename... A, typename... B>
-	struct concat<type_list<A...>, type_list<B...>> {
-		using type = type_list<A..., B...>;
-	};
-
-	template<typename... Args>
-	struct flatten_pack;
-
-	template<typename T>
-	struct flatten_one {
-		using type = type_list<T>;
-	};
-
-	template<typename... Inner>
-	struct flatten_one<_Sequential<Inner...>> {
-		using type = typename flatten_pack<Inner...>::type;
-	};
-
-	template<>
-	struct flatten_pack<> {
-		using type = type_list<>;
-	};
-
-	template<typename Head, typename... Tail>
-	struct flatten_pack<Head, Tail...> {
-		using type = typename concat<
-			typename flatten_one<Head>::type,
-			typename flatten_pack<Tail...>::type>::type;
-	};
-
-	template<typename List>
-	struct list_to_seq;
-	template<typename... Ts>
-	struct list_to_seq<type_list<Ts...>> {
-		using type = _Sequential<Ts...>;
-	};
-}
-// 依次执行模块。嵌套的Sequential会被展开。
-template<typename... Args>
-using Sequential = typename detail::list_to_seq<
-	typename detail::flatten_pack<Args...>::type>::type;
-
-struct _TimedModule : Module {
-	using Module::Module;
-	void Abort() override {
-		if (Timer) {
-			Timer->Stop();
-			UnregisterTimer();
-		}
-	}
-
-protected:
-	Timers_one_for_all::TimerClass* Timer = nullptr;
-	// 不检查当前Timer是否有效
-	void UnregisterTimer() {
-		Module::Container.UnregisterTimer(Timer);
-		Timer = nullptr;
-	}
-	struct _UnregisterTimer {
-		_TimedModule* const ContentModule;
-		void operator()() const {
-			ContentModule->UnregisterTimer();
-		}
-	};
-};
-struct _Delay : _TimedModule {
-	using _TimedModule::_TimedModule;
-	void Restart() override {
-		if (!Timer)
-			Timer = Module::Container.AllocateTimer();
-	}
-	bool Start(std::move_only_function<void()>& FC) override {
-		// 在冷静阶段，Restart会被高频执行，因此只能牺牲一下Start，确保Restart的效率
-		FinishCallback = [this, &FC]() {
-			UnregisterTimer();
-			FC();
-			};
-		Restart();
-		return true;
-	}
-
-protected:
-	// 确保直接Restart也能正常释放计时器
-	std::move_only_function<void()> FinishCallback{ _TimedModule::_UnregisterTimer{ this } };
-};
-template<typename Unit = Infinite, typename Value = Infinite>
-struct Delay : _Delay {
-protected:
-#pragma pack(push, 1)
-	struct InfoStruct {
-		uint8_t const NumFields = 3;
-		PodField<UID> const ID{ UID::Field_ID, _ModuleID<Delay>::ID };
-		PodField<UID> const UnitField{ UID::Field_Unit, _TypeID<Unit>::value };
-		PodField<UID const*> const Duration{ UID::Field_Duration, &_ModuleID<Value>::ID };
-	};
-#pragma pack(pop)
-	Value const* const DurationPtr = Module::Container.LoadModule<Value>();
-
-public:
-	using _Delay::_Delay;
-	void Restart() override {
-		_Delay::Restart();  // 不能用_TimedModule，调不到_Delay版本
-		_TimedModule::Timer->DoAfter(Unit{ DurationPtr->Current() }, FinishCallback);
-	}
-	InfoImplement;
-};
-template<typename Unit, typename Value>
-UID const Delay<Unit, Value>::ID = UID::Module_Delay;
-template<>
-struct Delay<Infinite, Infinite> : Module {
-
-	using Module::Module;
-	bool Start(std::move_only_function<void()>& FC) override {
-		FinishCallback = &FC;
-		return true;
-	}
-	void Skip() {
-		if (FinishCallback)
-			(*FinishCallback)();
-	}
-	InfoImplement;
-protected:
-#pragma pack(push, 1)
-	struct InfoStruct {
-		uint8_t const NumFields = 2;
-		PodField<UID> const ID{ UID::Field_ID, _ModuleID<Delay>::ID };
-		UID const Field2Name = UID::Field_Duration;
-		UID const Field2Type = UID::Type_Infinite;
-	};
-#pragma pack(pop)
-	std::move_only_function<void()>* FinishCallback = nullptr;
-};
-template<typename Content, typename Period>
-struct _RepeatEvery : _TimedModule {
-	using _TimedModule::_TimedModule;
-	void Abort() override {
-		ContentPtr->Abort();
-		_TimedModule::Abort();
-	}
-	void Restart() override {
-		if (Timer)
-			ContentPtr->Abort();
-		else
-			Timer = Module::Container.AllocateTimer();
-	}
-	bool Start(std::move_only_function<void()>& FC) override {
-		// 默认的无限重复，不需要FinishCallback。
-		Restart();
-		return true;
-	}
-
-protected:
-	Module* const ContentPtr = Module::Container.LoadModule<Content>();
-	std::move_only_function<void()> RepeatCallback{ _EmptyStart{ ContentPtr } };
-	Period const* const PeriodPtr = Module::Container.LoadModule<Period>();
-};
-/*
-每隔指定周期，执行一次内容模块。这个周期就是最终的绝对的周期长度，内容模块异步执行，不占用周期时间。第一次执行也需要等待周期时长之后。
-此模块为固定周期的高频循环优化，比组合使用Repeat和Delay效率更高更方便。但是，一旦此模块开始，周期长度即固定。如果采用随机周期值，那个周期值将在模块开始时确定，后续再改变随机变量值也不会改变此模块的周期，除非重启。因此，不能使用此模块实现每个周期时长随机。要实现此效果，请组合使用Repeat和Delay模块。
-*/
-template<typename Content, typename Unit, typename Period, typename Times = Infinite>
-struct RepeatEvery : _RepeatEvery<Content, Period> {
-protected:
-	std::move_only_function<void()> FinishCallback{ _TimedModule::_UnregisterTimer{ this } };
-	Times const* const TimesPtr = Module::Container.LoadModule<Times>();
-#pragma pack(push, 1)
-	struct InfoStruct {
-		uint8_t const NumFields = 5;
-		PodField<UID> const ID{ UID::Field_ID, _ModuleID<RepeatEvery>::ID };
-		PodField<UID const*> const ContentField{ UID::Field_Content, &_ModuleID<Content>::ID };
-		PodField<UID> const UnitField{ UID::Field_Unit, _TypeID<Unit>::value };
-		PodField<UID const*> const PeriodField{ UID::Field_Period, &_ModuleID<Period>::ID };
-		PodField<UID const*> const TimesField{ UID::Field_Times, &_ModuleID<Times>::ID };
-	};
-#pragma pack(pop)
-	using MyBase = _RepeatEvery<Content, Period>;
-
-public:
-	using MyBase::_RepeatEvery;
-	void Restart() override {
-		MyBase::Restart();
-		_TimedModule::Timer->RepeatEvery(Unit{ MyBase::PeriodPtr->Current() }, MyBase::RepeatCallback, TimesPtr->Current(), FinishCallback);
-	}
-	bool Start(std::move_only_function<void()>& FC) override {
-		if (!TimesPtr->Current())
-			return false;
-		FinishCallback = [this, &FC]() {
-			this->UnregisterTimer();
-			FC();
-			};
-		Restart();
-		return true;
-	}
-	static constexpr uint16_t NumTrials = _IDModule_t<Content>::NumTrials * Times::NumTrials;
-	InfoImplement;
-};
-template<typename Content, typename Unit, typename Period, typename Times>
-UID const RepeatEvery<Content, Unit, Period, Times>::ID = UID::Module_RepeatEvery;
-template<typename Content, typename Unit, typename Period>
-struct RepeatEvery<Content, Unit, Period, Infinite> : _RepeatEvery<Content, Period> {
-protected:
-#pragma pack(push, 1)
-	struct InfoStruct {
-		uint8_t const NumFields = 5;
-		PodField<UID> const ID{ UID::Field_ID, _ModuleID<RepeatEvery>::ID };
-		PodField<UID const*> const ContentField{ UID::Field_Content, &_ModuleID<Content>::ID };
-		PodField<UID> const UnitField{ UID::Field_Unit, _TypeID<Unit>::value };
-		PodField<UID const*> const PeriodField{ UID::Field_Period, &_ModuleID<Period>::ID };
-		UID const TimesFieldName = UID::Field_Times;
-		UID const TimesFieldType = UID::Type_Infinite;
-	};
-#pragma pack(pop)
-	using MyBase = _RepeatEvery<Content, Period>;
-
-public:
-	using MyBase::_RepeatEvery;
-	void Restart() override {
-		MyBase::Restart();
-		_TimedModule::Timer->RepeatEvery(Unit{ MyBase::PeriodPtr->Current() }, MyBase::RepeatCallback);
-	}
-	InfoImplement;
-};
-template<typename Content, typename Unit, typename Period>
-UID const RepeatEvery<Content, Unit, Period, Infinite>::ID = UID::Module_RepeatEvery;
-template<typename ContentA, typename ContentB, typename PeriodA, typename PeriodB>
-struct _DoubleRepeat : _TimedModule {
-	using _TimedModule::_TimedModule;
-	void Abort() override {
-		ContentAPtr->Abort();
-		ContentBPtr->Abort();
-		_TimedModule::Abort();
-	}
-	void Restart() override {
-		if (Timer) {
-			ContentAPtr->Abort();
-			ContentBPtr->Abort();
-		}
-		else
-			Timer = Module::Container.AllocateTimer();
-	}
-	bool Start(std::move_only_function<void()>& FC) override {
-		// 默认的无限重复，不需要FinishCallback。
-		Restart();
-		return true;
-	}
-
-protected:
-	Module* const ContentAPtr = Module::Container.LoadModule<ContentA>();
-	Module* const ContentBPtr = Module::Container.LoadModule<ContentB>();
-	std::move_only_function<void()> RepeatCallbackA{ _EmptyStart{ ContentAPtr } };
-	std::move_only_function<void()> RepeatCallbackB{ _EmptyStart{ ContentBPtr } };
-	PeriodA const* const PeriodAPtr = Module::Container.LoadModule<PeriodA>();
-	PeriodB const* const PeriodBPtr = Module::Container.LoadModule<PeriodB>();
-};
-/*
-等待时间A后，执行一次模块A；再等待时间B后，执行一次模块B，然后循环。周期总时长就是两个时间之和，不等待模块本身的执行时间。
-此模块为固定周期的高频循环优化，比组合使用Repeat和Delay效率更高更方便。但是，一旦此模块开始，周期长度即固定。如果采用随机周期值，那个周期值将在模块开始时确定，后续再改变随机变量值也不会改变此模块的周期，除非重启。因此，不能使用此模块实现每个周期时长随机。要实现此效果，请组合使用Repeat和Delay模块。重复次数为半周期数，即ContentA和ContentB共计执行Times次。
-*/
-template<typename ContentA, typename ContentB, typename Unit, typename PeriodA, typename PeriodB, typename Times = Infinite>
-struct DoubleRepeat : _DoubleRepeat<ContentA, ContentB, PeriodA, PeriodB> {
-protected:
-	std::move_only_function<void()> FinishCallback{ _TimedModule::_UnregisterTimer{ this } };
-#pragma pack(push, 1)
-	struct InfoStruct {
-		uint8_t const NumFields = 7;
-		PodField<UID> const ID{ UID::Field_ID, _ModuleID<DoubleRepeat>::ID };
-		PodField<UID const*> const ContentAField{ UID::Field_ContentA, &_ModuleID<ContentA>::ID };
-		PodField<UID const*> const ContentBField{ UID::Field_ContentB, &_ModuleID<ContentB>::ID };
-		PodField<UID> const UnitField{ UID::Field_Unit, _TypeID<Unit>::value };
-		PodField<UID const*> const PeriodAField{ UID::Field_PeriodA, &_ModuleID<PeriodA>::ID };
-		PodField<UID const*> const PeriodBField{ UID::Field_PeriodB, &_ModuleID<PeriodB>::ID };
-		PodField<UID const*> const TimesField{ UID::Field_Times, &_ModuleID<Times>::ID };
-	};
-#pragma pack(pop)
-	Times const* const TimesPtr = Module::Container.LoadModule<Times>();
-	using MyBase = _DoubleRepeat<ContentA, ContentB, PeriodA, PeriodB>;
-
-public:
-	using MyBase::_DoubleRepeat;
-	void Restart() override {
-		MyBase::Restart();
-		_TimedModule::Timer->DoubleRepeat(Unit{ MyBase::PeriodAPtr->Current() }, MyBase::RepeatCallbackA, Unit{ MyBase::PeriodBPtr->Current() }, MyBase::RepeatCallbackB, TimesPtr->Current(), FinishCallback);
-	}
-	bool Start(std::move_only_function<void()>& FC) override {
-		if (!TimesPtr->Current())
-			return false;
-		FinishCallback = [this, &FC]() {
-			this->UnregisterTimer();
-			FC();
-			};
-		Restart();
-		return true;
-	}
-	static constexpr uint16_t NumTrials = (Times::NumTrials + 1) / 2 * _IDModule_t<ContentA>::NumTrials + Times::NumTrials / 2 * _IDModule_t<ContentB>::NumTrials;
-	InfoImplement;
-};
-template<typename ContentA, typename ContentB, typename Unit, typename PeriodA, typename PeriodB, typename Times>
-UID const DoubleRepeat<ContentA, ContentB, Unit, PeriodA, PeriodB, Times>::ID = UID::Module_DoubleRepeat;
-template<typename ContentA, typename ContentB, typename Unit, typename PeriodA, typename PeriodB>
-struct DoubleRepeat<ContentA, ContentB, Unit, PeriodA, PeriodB, Infinite> : _DoubleRepeat<ContentA, ContentB, PeriodA, PeriodB> {
-protected:
-#pragma pack(push, 1)
-	struct InfoStruct {
-		uint8_t const NumFields = 7;
-		PodField<UID> const ID{ UID::Field_ID, _ModuleID<DoubleRepeat>::ID };
-		PodField<UID const*> const ContentAField{ UID::Field_ContentA, &_ModuleID<ContentA>::ID };
-		PodField<UID const*> const ContentBField{ UID::Field_ContentB, &_ModuleID<ContentB>::ID };
-		PodField<UID> const UnitField{ UID::Field_Unit, _TypeID<Unit>::value };
-		PodField<UID const*> const PeriodAField{ UID::Field_PeriodA, &_ModuleID<PeriodA>::ID };
-		PodField<UID const*> const PeriodBField{ UID::Field_PeriodB, &_ModuleID<PeriodB>::ID };
-		UID const TimesFieldName = UID::Field_Times;
-		UID const TimesFieldType = UID::Type_Infinite;
-	};
-#pragma pack(pop)
-	using MyBase = _DoubleRepeat<ContentA, ContentB, PeriodA, PeriodB>;
-
-public:
-	using MyBase::_DoubleRepeat;
-	void Restart() override {
-		MyBase::Restart();
-		_TimedModule::Timer->DoubleRepeat(Unit{ MyBase::PeriodAPtr->Current() }, MyBase::RepeatCallbackA, Unit{ MyBase::PeriodBPtr->Current() }, MyBase::RepeatCallbackB);
-	}
-	InfoImplement;
-};
-template<typename ContentA, typename ContentB, typename Unit, typename PeriodA, typename PeriodB>
-UID const DoubleRepeat<ContentA, ContentB, Unit, PeriodA, PeriodB, Infinite>::ID = UID::Module_DoubleRepeat;
-struct _InstantaneousModule : Module {
-	using Module::Module;
-	bool Start(std::move_only_function<void()>& FC) override {
-		Restart();
-		return false;
-	}
-};
-template<typename Target>
-struct ModuleAbort : _InstantaneousModule {
-protected:
-	Module* const TargetPtr = Module::Container.LoadModule<Target>();
-#pragma pack(push, 1)
-	struct InfoStruct {
-		uint8_t const NumFields = 2;
-		PodField<UID> const ID{ UID::Field_ID, _ModuleID<ModuleAbort>::ID };
-		PodField<UID const*> const TargetField{ UID::Field_Target, &_ModuleID<Target>::ID };
-	};
-#pragma pack(pop)
-public:
-	using _InstantaneousModule::_InstantaneousModule;
-	void Restart() override {
-		TargetPtr->Abort();
-	}
-	InfoImplement;
-};
-template<typename Target>
-UID const ModuleAbort<Target>::ID = UID::Module_Abort;
-template<typename Target>
-struct ModuleSkip : _InstantaneousModule {
-protected:
-	Target* const TargetPtr = Module::Container.LoadModule<Target>();
-#pragma pack(push, 1)
-	struct InfoStruct {
-		uint8_t const NumFields = 2;
-		PodField<UID> const ID{ UID::Field_ID, _ModuleID<ModuleSkip>::ID };
-		PodField<UID const*> const TargetField{ UID::Field_Target, &_ModuleID<Target>::ID };
-	};
-#pragma pack(pop)
-public:
-	using _InstantaneousModule::_InstantaneousModule;
-	void Restart() override {
-		TargetPtr->Skip();
-	}
-	InfoImplement;
-};
-template<typename Target>
-UID const ModuleSkip<Target>::ID = UID::Module_Skip;
-template<typename Target>
-struct ModuleRestart : _InstantaneousModule {
-protected:
-	Module* const TargetPtr = Module::Container.LoadModule<Target>();
-#pragma pack(push, 1)
-	struct InfoStruct {
-		uint8_t const NumFields = 2;
-		PodField<UID> const ID{ UID::Field_ID, _ModuleID<ModuleRestart>::ID };
-		PodField<UID const*> const TargetField{ UID::Field_Target, &_ModuleID<Target>::ID };
-	};
-#pragma pack(pop)
-public:
-	using _InstantaneousModule::_InstantaneousModule;
-	void Restart() override {
-		TargetPtr->Restart();
-	}
-	InfoImplement;
-};
-template<typename Target>
-UID const ModuleRestart<Target>::ID = UID::Module_Restart;
-template<typename Target>
-struct ModuleRandomize : _InstantaneousModule {
-protected:
-	IRandom* const TargetPtr = Module::Container.LoadModule<Target>();
-#pragma pack(push, 1)
-	struct InfoStruct {
-		uint8_t const NumFields = 2;
-		PodField<UID> const ID{ UID::Field_ID, _ModuleID<ModuleRandomize>::ID };
-		PodField<UID const*> const TargetField{ UID::Field_Target, &_ModuleID<Target>::ID };
-	};
-#pragma pack(pop)
-public:
-	using _InstantaneousModule::_InstantaneousModule;
-	void Restart() override {
-		TargetPtr->Randomize();
-	}
-	InfoImplement;
-};
-template<typename Target>
-UID const ModuleRandomize<Target>::ID = UID::Module_Randomize;
-template<uint8_t Pin, bool HighOrLow>
-struct DigitalWrite : _InstantaneousModule {
-protected:
-#pragma pack(push, 1)
-	struct InfoStruct {
-		uint8_t const NumFields = 3;
-		PodField<UID> const ID{ UID::Field_ID, _ModuleID<DigitalWrite>::ID };
-		PodField<uint8_t> const PinField{ UID::Field_Pin, Pin };
-		PodField<bool> const HighOrLowField{ UID::Field_HighOrLow, HighOrLow };
-	};
-#pragma pack(pop)
-public:
-	DigitalWrite(Process& Container)
-		: _InstantaneousModule(Container) {
-		Quick_digital_IO_interrupt::PinMode<Pin, OUTPUT>();
-	}
-	void Restart() override {
-		Quick_digital_IO_interrupt::DigitalWrite<Pin, HighOrLow>();
-	}
-	InfoImplement;
-};
-template<uint8_t Pin, bool HighOrLow>
-UID const DigitalWrite<Pin, HighOrLow>::ID = UID::Module_DigitalWrite;
-template<uint8_t Pin>
-struct DigitalToggle : _InstantaneousModule {
-protected:
-#pragma pack(push, 1)
-	struct InfoStruct {
-		uint8_t const NumFields = 2;
-		PodField<UID> const ID{ UID::Field_ID, _ModuleID<DigitalToggle>::ID };
-		PodField<uint8_t> const PinField{ UID::Field_Pin, Pin };
-	};
-#pragma pack(pop)
-public:
-	DigitalToggle(Process& Container)
-		: _InstantaneousModule(Container) {
-		Quick_digital_IO_interrupt::PinMode<Pin, OUTPUT>();
-	}
-	void Restart() override {
-		Quick_digital_IO_interrupt::DigitalToggle<Pin>();
-	}
-	InfoImplement;
-};
-template<uint8_t Pin>
-UID const DigitalToggle<Pin>::ID = UID::Module_DigitalToggle;
-// 此模块可以用ModuleAbort停止监视
-template<uint8_t Pin, typename Monitor>
-class MonitorPin : public _InstantaneousModule {
-	PinListener const Listener;
-#pragma pack(push, 1)
-	struct InfoStruct {
-		uint8_t const NumFields = 3;
-		PodField<UID> const ID{ UID::Field_ID, _ModuleID<MonitorPin>::ID };
-		PodField<uint8_t> const PinField{ UID::Field_Pin, Pin };
-		PodField<UID const*> const MonitorField{ UID::Field_Monitor, &_ModuleID<Monitor>::ID };
-	};
-#pragma pack(pop)
-public:
-	MonitorPin(Process& Container)
-		: _InstantaneousModule(Container), Listener{ Pin, std::make_shared<std::move_only_function<void()>>([MonitorPtr = Module::Container.LoadModule<Monitor>()]() {
-														 MonitorPtr->Start(_EmptyCallback);
-													   }) } {
-		Quick_digital_IO_interrupt::PinMode<Pin, INPUT>();
-	}
-	void Abort() override {
-		Listener.Pause();
-		Module::Container.ActiveInterrupts.erase(&Listener);
-	}
-	void Restart() override {
-		Listener.Continue();
-		Module::Container.ActiveInterrupts.insert(&Listener);
-	}
-	InfoImplement;
-};
-template<uint8_t Pin, typename Monitor>
-UID const MonitorPin<Pin, Monitor>::ID = UID::Module_MonitorPin;
-template<UID Message>
-struct SerialMessage : _InstantaneousModule {
-protected:
-#pragma pack(push, 1)
-	struct InfoStruct {
-		uint8_t const NumFields = 2;
-		PodField<UID> const ID{ UID::Field_ID, _ModuleID<SerialMessage>::ID };
-		PodField<UID> const MessageField{ UID::Field_Message, Message };
-	};
-#pragma pack(pop)
-public:
-	using _InstantaneousModule::_InstantaneousModule;
-	void Restart() override {
-		SerialStream.AsyncInvoke(static_cast<Async_stream_IO::Port>(UID::PortC_Signal), &Container, Message);
-	}
-	InfoImplement;
-};
-template<UID Message>
-UID const SerialMessage<Message>::ID = UID::Module_SerialMessage;
-// 被Async包装的延时模块将异步执行，即不等待其结束直接返回继续。但是，对其调用Abort仍可以放弃内容模块。
-template<typename Content>
-struct Async : _InstantaneousModule {
-protected:
-	Module* const ContentPtr = Module::Container.LoadModule<Content>();
-#pragma pack(push, 1)
-	struct InfoStruct {
-		uint8_t const NumFields = 2;
-		PodField<UID> const ID{ UID::Field_ID, _ModuleID<Async>::ID };
-		PodField<UID const*> const ContentField{ UID::Field_Content, &_ModuleID<Content>::ID };
-	};
-#pragma pack(pop)
-public:
-	using _InstantaneousModule::_InstantaneousModule;
-	void Abort() override {
-		ContentPtr->Abort();
-	}
-	void Restart() override {
-		Abort();
-		ContentPtr->Start(_EmptyCallback);
-	}
-	static constexpr uint16_t NumTrials = _IDModule_t<Content>::NumTrials;
-	InfoImplement;
-};
-template<typename Content>
-UID const Async<Content>::ID = UID::Module_Async;
-// 回合是断线重连后自动恢复的最小单元，并且在回合开始时向串口发送信号
-template<UID TrialID, typename Content>
-struct Trial : Module {
-protected:
-	Module* const ContentPtr = Module::Container.LoadModule<Content>();
-	std::move_only_function<void()>* FinishCallback = &_EmptyCallback;
-	void _Restart() {
-		Abort();
-		SerialStream.AsyncInvoke(static_cast<uint8_t>(UID::PortC_TrialStart), &Container, TrialID);
-	}
-#pragma pack(push, 1)
-	struct InfoStruct {
-		uint8_t const NumFields = 2;
-		PodField<UID> const ID{ UID::Field_ID, TrialID };
-		PodField<UID const*> const ContentField{ UID::Field_Content, &_ModuleID<Content>::ID };
-	};
-#pragma pack(pop)
-public:
-	using Module::Module;
-	void Abort() override {
-		ContentPtr->Abort();
-	}
-	void Restart() override {
-		_Restart();
-		ContentPtr->Start(*FinishCallback);
-	}
-	bool Start(std::move_only_function<void()>& FC) override {
-		auto const It = Module::Container.TrialsDone.find(TrialID);
-		if (It != Module::Container.TrialsDone.end())
-			if (It->second) {
-				if (!--It->second)
-					Module::Container.TrialsDone.erase(It);
-				return false;
-			}
-			else
-				Module::Container.TrialsDone.erase(It);
-		_Restart();
-		if (ContentPtr->Start(FC)) {
-			FinishCallback = &FC;
-			return true;
-		}
-		return false;
-	}
-	static constexpr uint16_t NumTrials = 1;
-	InfoImplement;
-};
-template<UID TrialID, typename Content>
-UID const Trial<TrialID, Content>::ID = TrialID;
-// 将一个清理模块附加到目标模块上，开始、重启、终止或析构此模块前都将先执行清理模块，但目标模块正常结束时则不会清理。清理模块一般应是瞬时的，如果有延时操作则不会等待其完成。
-template<typename Target, typename Cleaner>
-struct CleanWhenAbort : Module {
-protected:
-	Module* const TargetPtr = Module::Container.LoadModule<Target>();
-	std::move_only_function<void()>* FinishCallback = &_EmptyCallback;
-	std::move_only_function<void()> TargetCallback = [this]() {
-		Module::Container.ExtraCleaners.erase(&StartCleaner);
-		(*FinishCallback)();
-		};
-	std::move_only_function<void()> StartCleaner = [CleanerPtr = Module::Container.LoadModule<Cleaner>()]() {
-		CleanerPtr->Start(_EmptyCallback);
-		};
-	void _Abort() {
-		TargetPtr->Abort();
-		StartCleaner();
-	}
-#pragma pack(push, 1)
-	struct InfoStruct {
-		uint8_t const NumFields = 3;
-		PodField<UID> const ID{ UID::Field_ID, _ModuleID<CleanWhenAbort>::ID };
-		PodField<UID const*> const TargetField{ UID::Field_Target, &_ModuleID<Target>::ID };
-		PodField<UID const*> const CleanerField{ UID::Field_Cleaner, &_ModuleID<Cleaner>::ID };
-	};
-#pragma pack(pop)
-public:
-	using Module::Module;
-	void Abort() override {
-		_Abort();
-		Module::Container.ExtraCleaners.erase(&StartCleaner);
-	}
-	void Restart() override {
-		_Abort();
-		if (TargetPtr->Start(TargetCallback))
-			Module::Container.ExtraCleaners.insert(&StartCleaner);
-	}
-	bool Start(std::move_only_function<void()>& FC) override {
-		_Abort();
-		if (TargetPtr->Start(TargetCallback)) {
-			FinishCallback = &FC;
-			Module::Container.ExtraCleaners.insert(&StartCleaner);
-			return true;
-		}
-		return false;
-	}
-	~CleanWhenAbort() {
-		StartCleaner();
-		Module::Container.ExtraCleaners.erase(&StartCleaner);
-	}
-	static constexpr uint16_t NumTrials = _IDModule_t<Target>::NumTrials;
-	InfoImplement;
-};
-template<typename Target, typename Cleaner>
-UID const CleanWhenAbort<Target, Cleaner>::ID = UID::Module_CleanWhenAbort;
-template<UID UniqueID = UID::Module_DynamicSlot>
-struct DynamicSlot : Module {
-protected:
-#pragma pack(push, 1)
-	struct InfoStruct {
-		uint8_t const NumFields = 1;
-		PodField<UID> const ID{ UID::Field_ID, _ModuleID<DynamicSlot>::ID };
-	};
-#pragma pack(pop)
-public:
-	using Module::Module;
-	void Abort() override {
-		if (ContentPtr)
-			ContentPtr->Abort();
-	}
-	void Restart() override {
-		if (ContentPtr)
-			ContentPtr->Restart();
-	}
-	bool Start(std::move_only_function<void()>& FC) override {
-		return ContentPtr && ContentPtr->Start(FC);
-	}
-	Module* ContentPtr = nullptr;
-	InfoImplement;
-	template<typename Content>
-	struct Load : _InstantaneousModule {
-	protected:
-		DynamicSlot* const SlotPtr = Module::Container.LoadModule<DynamicSlot>();
-		Module* const ContentPtr;
-#pragma pack(push, 1)
-		struct InfoStruct {
-			uint8_t const NumFields = 3;
-			PodField<UID> const ID{ UID::Field_ID, _ModuleID<Load>::ID };
-			PodField<UID const*> const Slot{ UID::Field_Slot, &_ModuleID<DynamicSlot>::ID };
-			PodField<UID const*> ContentField;
-			constexpr InfoStruct()
-				: ContentField{ UID::Field_Content, &_ModuleID<Content>::ID } {
-			}
-		};
-#pragma pack(pop)
-	public:
-		//SAM编译器bug：使用了内联struct模板参数的成员初始化只能写在构造方法里，不能直接成员初始化，成员初始化无法访问内联模板参数
-		Load(Process& Container)
-			: _InstantaneousModule(Container), ContentPtr{ Container.LoadModule<Content>() } {
-		}
-		void Restart() override {
-			SlotPtr->ContentPtr = ContentPtr;
-		}
-		InfoImplement;
-	};
-	struct Clear : _InstantaneousModule {
-	protected:
-		DynamicSlot* const SlotPtr = Module::Container.LoadModule<DynamicSlot>();
-#pragma pack(push, 1)
-		struct InfoStruct {
-			uint8_t const NumFields = 2;
-			PodField<UID> const ID{ UID::Field_ID, _ModuleID<Clear>::ID };
-			PodField<UID const*> const Slot{ UID::Field_Slot, &_ModuleID<DynamicSlot>::ID };
-		};
-#pragma pack(pop)
-	public:
-		using _InstantaneousModule::_InstantaneousModule;
-		void Restart() override {
-			SlotPtr->ContentPtr = nullptr;
-		}
-		InfoImplement;
-	};
-};
-template<UID UniqueID>
-UID const DynamicSlot<UniqueID>::ID = UniqueID;
-template<UID UniqueID>
-template<typename Content>
-UID const DynamicSlot<UniqueID>::Load<Content>::ID = UID::Module_LoadSlot;
-template<UID UniqueID>
-UID const DynamicSlot<UniqueID>::Clear::ID = UID::Module_ClearSlot;
-
-template<typename TModule>
-uint16_t Session(Process* P) {
-	return P->LoadStartModule<TModule>();
-};
-#define Pin static constexpr uint8_t
-template<typename Target>
-UID const& _ModuleID<Target>::ID = Target::ID;
-
-// 将模块绑定到指定UID，方便循环引用，并在返回信息中显示自定义名称
-#define AssignModuleID(TargetModule, TargetID) \
-	template<> \
-	struct _ModuleID<TargetModule> { \
-		static UID const ID; \
-	}; \
-	UID const _ModuleID<TargetModule>::ID = TargetID; \
-	template<> \
-	struct _IDModule<IDModule<TargetID>> { \
-		using type = TargetModule; \
-	}; \
-	template<> \
-	struct _ModuleID<IDModule<TargetID>> : _ModuleID<TargetModule> { \
+#pragma once
+// 以下构建选项影响模块和进程的布局，必须对所有翻译单元一致，因此只能在此定义。
+// 取消注释以构建分配计数插桩版本：替换全局operator new，统计堆分配次数，主机可通过PortA_AllocationCount读取总数、通过PortA_ModuleAllocations读取各模块的计数，用于验证命令路径和模块执行不分配堆内存。同时测量计时器中断的处理耗时，主机可通过PortA_TimerStatistics读取。正式实验不应启用。
+// #define GBEC_COUNT_ALLOCATIONS
+// 取消注释以推迟计时器到期的续延：计时器中断只将结束续延放入RunQueue，由loop在主线程中执行，以免长续延链占用中断、使其它引脚的边沿丢失。周期内容（RepeatEvery、DoubleRepeat每个周期启动的模块）仍在中断中启动，以保持定时。
+// #define GBEC_DEFER_TIMER_CONTINUATIONS
+// 取消注释以静态分派子模块调用：父模块按子模块的实际类型直接调用其Start、Abort和Restart，不经虚表，编译器可以内联整条模块链，缩短每一跳的延迟。代价是每种组合各自展开，程序体积可能增大。
+// #define GBEC_STATIC_DISPATCH
+#include "UID.hpp"
+#include "Async_stream_IO.hpp"
+#include "Timers_one_for_all.hpp"
+#include <Quick_digital_IO_interrupt.hpp>
+#include <map>
+#include <unordered_map>
+#include <random>
+#include <sstream>
+#include <functional>
+#include <queue>
+#include <set>
+#include <iterator>
+#include <numeric>
+#include <tuple>
+using namespace std::chrono_literals;
+using DurationRep = uint32_t;
+// 编译期资源估计用到的标准容器开销
+namespace detail {
+	// 每个堆块的管理开销
+#ifdef ARDUINO_ARCH_AVR
+	constexpr size_t heap_overhead = 2;
+#endif
+#ifdef ARDUINO_ARCH_SAM
+	constexpr size_t heap_overhead = 8;
+#endif
+	// 红黑树（std::set、std::map）节点的估计大小：颜色和3个指针，加上元素
+	template<typename T>
+	constexpr size_t tree_node_bytes = 4 * sizeof(void*) + sizeof(T) + heap_overhead;
+	// std::move_only_function能就地存放的可调用对象大小。标准库未公开此值，保守地按全部存放在堆上估计
+	constexpr size_t function_inline_bytes = 0;
+	// std::move_only_function存放CallableBytes字节的可调用对象时，在自身之外占用的堆内存
+	constexpr size_t function_heap_bytes(size_t CallableBytes) {
+		return CallableBytes > function_inline_bytes ? CallableBytes + heap_overhead : 0;
+	}
+}
+// 设备端事件时间戳，单位微秒，随micros()约71.6分钟回绕一次，由主机借助自身时钟展开。引脚事件的时刻在中断处理函数中记录，ClearPending执行其回调期间由Now返回该时刻；其它事件产生于计时器中断或主线程中，Now直接返回当前时刻。
+struct EventClock {
+	// 中断安全。计时器回调以Unpinned包围，因此即使打断了ClearPending中的回调，也不会看到钉住的时刻。
+	static uint32_t Now() {
+		return Pinned ? PinnedMicros : micros();
+	}
+	// 在作用域内取消钉住，析构时恢复。用于计时器回调：ClearPending启用中断执行引脚回调，计时器中断可能恰好打断其中。
+	struct Unpinned {
+		bool const Previous = Pinned;
+		Unpinned() {
+			Pinned = false;
+		}
+		~Unpinned() {
+			Pinned = Previous;
+		}
+	};
+
+protected:
+	friend struct PinListener;
+	static bool Pinned;
+	static uint32_t PinnedMicros;
+};
+// 引脚监听器。每个引脚的监听器以侵入式双向链表串起，链接就嵌在监听器中，登记、注销都是O(1)且不分配堆内存。
+struct PinListener {
+	uint8_t const Pin;
+	std::move_only_function<void()> Callback;
+
+	PinListener(uint8_t Pin, std::move_only_function<void()>&& Callback)
+		: Pin(Pin), Callback(std::move(Callback)) {
+	}
+	// 链表持有监听器地址，不能复制
+	PinListener(PinListener const&) = delete;
+	PinListener& operator=(PinListener const&) = delete;
+
+	// 中断安全。未登记的监听器无效果。
+	void Pause() {
+		Quick_digital_IO_interrupt::InterruptGuard const _;
+		if (!Linked)
+			return;
+		//正在分派本引脚的，游标若指向自身则后移，因此分派中移除任何监听器都是安全的，已移除的不会再被调用
+		for (_Cursor* C = Cursors; C; C = C->Outer)
+			if (C->Next == this)
+				C->Next = Next;
+		PinState& PS = PinStates[Pin];
+		(Previous ? Previous->Next : PS.Head) = Next;
+		if (Next)
+			Next->Previous = Previous;
+		Previous = Next = nullptr;
+		Linked = false;
+		if (!PS.Head) {
+			Quick_digital_IO_interrupt::DetachInterrupt(Pin);
+
+			//已无人监听，丢弃尚未处理的中断
+			PendingMask[Pin >> 3] &= ~(1 << (Pin & 7));
+		}
+	}
+
+	// 中断安全。已登记的监听器不会重复登记。
+	void Continue() {
+		Quick_digital_IO_interrupt::InterruptGuard const _;
+		if (Linked)
+			return;
+		PinState& PS = PinStates[Pin];
+		bool const WasEmpty = !PS.Head;
+		//插在表头，即已分派过的位置，因此分派期间加入的不参与本次分派
+		Next = PS.Head;
+		if (Next)
+			Next->Previous = this;
+		PS.Head = this;
+		Linked = true;
+		//分派期间引脚中断保持脱离，分派结束后再启用
+		if (WasEmpty && !_Dispatching(Pin))
+			Quick_digital_IO_interrupt::AttachInterrupt<RISING>(Pin, PinInterrupt{ Pin });
+	}
+
+	// 中断安全
+	~PinListener() {
+		Pause();
+	}
+
+	/*中断安全。没有待处理的引脚时只检测一个字节即返回，可在loop中高频调用。
+	只在禁用中断时取走待处理引脚的快照，回调在启用中断时执行，因此不会推迟计时器中断，Tone、RepeatEvery等在监视链执行期间仍保持定时。回调中可能再次进入本函数（如等待串口时），不会重复处理同一引脚：引脚中断在其分派结束前保持脱离。
+	*/
+	static void ClearPending() {
+		if (!AnyPending)
+			return;
+		uint8_t Snapshot[sizeof(PendingMask)];
+		{
+			Quick_digital_IO_interrupt::InterruptGuard const _;
+			AnyPending = false;
+			for (uint8_t Byte = 0; Byte < sizeof(PendingMask); ++Byte) {
+				Snapshot[Byte] = PendingMask[Byte];
+				PendingMask[Byte] = 0;
+			}
+		}
+		bool const WasPinned = EventClock::Pinned;
+		uint32_t const WasPinnedMicros = EventClock::PinnedMicros;
+		for (uint8_t Byte = 0; Byte < sizeof(Snapshot); ++Byte)
+			for (uint8_t Bits = Snapshot[Byte]; Bits; Bits &= Bits - 1)
+				_Dispatch((Byte << 3) + __builtin_ctz(Bits));
+		EventClock::PinnedMicros = WasPinnedMicros;
+		EventClock::Pinned = WasPinned;
+	}
+
+protected:
+	PinListener* Previous = nullptr;
+	PinListener* Next = nullptr;
+	bool Linked = false;
+
+	struct PinState {
+		// 最近一次中断发生的时刻
+		uint32_t Micros;
+		PinListener* Head = nullptr;
+	};
+	// 按引脚号直接索引，中断处理函数中不查找也不分配
+	static PinState PinStates[NUM_DIGITAL_PINS];
+	// 每个引脚一位，由引脚中断置位，ClearPending禁用中断时读取并清零
+	static uint8_t volatile PendingMask[(NUM_DIGITAL_PINS + 7) / 8];
+	// PendingMask中是否有任何置位。单字节读写不可分割，ClearPending借此免于逐字节检测。
+	static bool volatile AnyPending;
+
+	// 正在进行的分派的游标，指向下一个要调用的监听器。ClearPending可能重入，各层游标在栈上串成链表。
+	struct _Cursor {
+		uint8_t const Pin;
+		PinListener* Next;
+		_Cursor* Outer;
+	};
+	static _Cursor* Cursors;
+	// 中断不安全
+	static bool _Dispatching(uint8_t Pin) {
+		for (_Cursor const* C = Cursors; C; C = C->Outer)
+			if (C->Pin == Pin)
+				return true;
+		return false;
+	}
+	// 启用中断时调用一个引脚的全部回调。只在禁用中断时读写链表和游标，其间计时器中断中的Pause和Continue都是安全的。
+	static void _Dispatch(uint8_t Pin) {
+		PinState& PS = PinStates[Pin];
+		EventClock::PinnedMicros = PS.Micros;
+		EventClock::Pinned = true;
+		_Cursor Cursor{ Pin };
+		{
+			Quick_digital_IO_interrupt::InterruptGuard const _;
+			Cursor.Next = PS.Head;
+			Cursor.Outer = Cursors;
+			Cursors = &Cursor;
+		}
+		for (;;) {
+			PinListener* Current;
+			{
+				Quick_digital_IO_interrupt::InterruptGuard const _;
+				Current = Cursor.Next;
+				if (!Current)
+					break;
+				Cursor.Next = Current->Next;
+			}
+			Current->Callback();
+		}
+		Quick_digital_IO_interrupt::InterruptGuard const _;
+		Cursors = Cursor.Outer;
+		//回调可能已使本引脚无人监听
+		if (PS.Head)
+			Quick_digital_IO_interrupt::AttachInterrupt<RISING>(Pin, PinInterrupt{ Pin });
+	}
+
+	/*无需记住Callback，只需根据Pin从全局列表中检索并转移Callback。每个引脚对应的Callback列表需要对全局ClearPending可见，因此不能被任何单个对象私有。
+	此对象只有一个字节，通常直接传值即可，无需考虑拷贝开销。
+	*/
+	struct PinInterrupt {
+		uint8_t const Pin;  //Pin不能是模板参数：需要接受运行时值
+
+		//此函数被引脚中断调用，因此中断安全
+		void operator()() const {
+			PinStates[Pin].Micros = micros();
+			PendingMask[Pin >> 3] |= 1 << (Pin & 7);
+			AnyPending = true;
+			Quick_digital_IO_interrupt::DetachInterrupt(Pin);
+		}
+	};
+};
+
+inline static void InfoWrite(std::ostringstream& InfoStream, UID InfoValue) {
+	InfoStream.put(static_cast<char>(InfoValue));
+}
+inline static void InfoWrite(std::ostringstream& InfoStream, uint8_t InfoValue) {
+	InfoStream.put(static_cast<char>(InfoValue));
+}
+template<typename T>
+inline static void InfoWrite(std::ostringstream& InfoStream, T InfoValue) {
+	InfoStream.write(reinterpret_cast<const char*>(&InfoValue), sizeof(InfoValue));
+}
+// 强制要求2个以上输入，以免递归
+template<typename T1, typename T2, typename... T>
+inline static void InfoWrite(std::ostringstream& InfoStream, T1 InfoValue1, T2 InfoValue2, T... InfoValues) {
+	int _[] = { (InfoWrite(InfoStream, InfoValue1), 0), (InfoWrite(InfoStream, InfoValue2), 0), (InfoWrite(InfoStream, InfoValues), 0)... };
+}
+extern Async_stream_IO::AsyncStream SerialStream;
+
+template<typename Target>
+struct _ModuleID {
+	static UID const& ID;
+};
+struct Process;
+// 模块的标记基类，不含虚函数。模块信息在编译期生成并存放在闪存中，参见InfoImplement和_InfoBlob；析构经_ModuleTable按实际类型进行。
+struct IInformative {
+
+	// 编译期资源估计，由SessionBudget汇总，派生类可覆盖。模块自身的大小已计入场地，HeapBytes是模块在自身大小之外可能占用的堆内存，例如std::move_only_function成员存不下的可调用对象，参见detail::function_heap_bytes；MaxTimers是模块在前台执行期间（含其前台执行的子模块）同时占用的计时器数上限。
+	// 会在后台执行子模块的（如Async、MonitorPin），应将那些子模块列入BackgroundModules类型列表，其计时器另行累加。
+	static constexpr size_t HeapBytes = 0;
+	static constexpr uint8_t MaxTimers = 0;
+	// 断点中此模块及其前台执行路径上的子模块至多占用的字节数
+	static constexpr size_t CheckpointBytes = 0;
+	// 从断点恢复时，执行路径之前被跳过的此类模块仍会重新执行一次，以恢复引脚电平、后台监视等设备状态。只应用于瞬时完成、不发送事件、重复执行也无副作用的模块，例如DigitalWrite，以及只重新布防、不启动子模块的MonitorPin。
+	static constexpr bool ReplayOnResume = false;
+};
+// 可作为续延目标的对象
+struct IResumable {
+	// 由Continuation调用。Slot用于区分同一对象上的多个续点。
+	virtual void Resume(uint8_t Slot) = 0;
+};
+// 模块执行完毕后的续延，即调用Target的Resume(Slot)。只有一个指针和一个序号，可以平凡复制，不需要类型擦除的存储，也不会分配内存。Target为nullptr表示无事可做。
+struct Continuation {
+	IResumable* Target = nullptr;
+	uint8_t Slot = 0;
+	void operator()() const {
+		if (Target)
+			Target->Resume(Slot);
+	}
+	explicit operator bool() const {
+		return Target;
+	}
+};
+#ifdef GBEC_COUNT_ALLOCATIONS
+// 分配计数插桩：全局operator new调用Count，将每次分配计入当前归属的模块。
+struct _AllocationOwner {
+	Process* Container;
+	void const* Owner;
+	// 是否在模块构造期间
+	bool Loading;
+	static _AllocationOwner Current;
+	static void Count();
+};
+// 在作用域内将分配归属于指定模块，析构时恢复原归属。设于模块构造、进程入口、计时器回调和引脚回调处，因此分配计入引发它的那次执行的入口模块。
+struct _AllocationScope {
+	_AllocationOwner const Previous;
+	_AllocationScope(Process& Container, void const* Owner, bool Loading = false)
+		: Previous(_AllocationOwner::Current) {
+		_AllocationOwner::Current = { &Container, Owner, Loading };
+	}
+	_AllocationScope(_AllocationOwner Owner)
+		: Previous(_AllocationOwner::Current) {
+		_AllocationOwner::Current = Owner;
+	}
+	~_AllocationScope() {
+		_AllocationOwner::Current = Previous;
+	}
+};
+#define GBEC_ALLOCATION_SCOPE(...) _AllocationScope const _AllocationScope_{ __VA_ARGS__ }
+#else
+#define GBEC_ALLOCATION_SCOPE(...)
+#endif
+#ifdef GBEC_COUNT_ALLOCATIONS
+// 计时器中断处理耗时的插桩统计。Scope设于各计时器回调的入口；SoftTimer的回调嵌套在其_Tick中，只有最外层计时。
+struct TimerIsrStatistics {
+	uint32_t Count;
+	uint32_t TotalMicros;
+	uint32_t MaxMicros;
+	static TimerIsrStatistics Current;
+	static uint8_t Depth;
+	struct Scope {
+		uint32_t const Begin = micros();
+		Scope() {
+			++Depth;
+		}
+		~Scope() {
+			if (--Depth)
+				return;
+			uint32_t const Micros = micros() - Begin;
+			++Current.Count;
+			Current.TotalMicros += Micros;
+			if (Micros > Current.MaxMicros)
+				Current.MaxMicros = Micros;
+		}
+	};
+};
+#define GBEC_TIMER_ISR_SCOPE() TimerIsrStatistics::Scope const _TimerIsrScope_
+#else
+#define GBEC_TIMER_ISR_SCOPE()
+#endif
+#ifdef GBEC_DEFER_TIMER_CONTINUATIONS
+// 每级优先的队列容量
+#ifndef GBEC_RUN_QUEUE_CAPACITY
+#define GBEC_RUN_QUEUE_CAPACITY 16
+#endif
+// 计时器到期后推迟执行的续延。计时器中断只入队，由loop调用Drain在主线程中逐个执行，因此长续延链不再占用中断。分两级优先，每取一个续延都先看高优先级队列。
+struct RunQueue {
+	enum Priority : uint8_t {
+		// 微秒级硬件计时器的到期
+		High,
+		// 毫秒级软件计时器的到期
+		Normal,
+		NumPriorities
+	};
+	// 中断安全。队列已满时就地执行，并计入Overflows。
+	static void Post(Continuation C, Priority P) {
+		{
+			Quick_digital_IO_interrupt::InterruptGuard const _;
+			_Ring& Q = Queues[P];
+			if (Q.Size < GBEC_RUN_QUEUE_CAPACITY) {
+				Q.Entries[(Q.Head + Q.Size) % GBEC_RUN_QUEUE_CAPACITY] = {
+					C,
+#ifdef GBEC_COUNT_ALLOCATIONS
+					_AllocationOwner::Current,
+#endif
+				};
+				if (++Q.Size > HighWater)
+					HighWater = Q.Size;
+				return;
+			}
+			++Overflows;
+		}
+		C();
+	}
+	// 在loop中调用，中断必须已启用
+	static void Drain() {
+		for (;;) {
+			_Entry Next;
+			{
+				Quick_digital_IO_interrupt::InterruptGuard const _;
+				_Ring* Q = Queues;
+				while (!Q->Size)
+					if (++Q == Queues + NumPriorities)
+						return;
+				Next = Q->Entries[Q->Head];
+				Q->Head = (Q->Head + 1) % GBEC_RUN_QUEUE_CAPACITY;
+				--Q->Size;
+			}
+			GBEC_ALLOCATION_SCOPE(Next.Owner);
+			Next.Target();
+		}
+	}
+	// 中断安全。丢弃尚未执行的C，用于中止已到期但续延尚在排队的模块。
+	static void Cancel(Continuation C) {
+		_Cancel([C](Continuation const& Queued) {
+			return Queued.Target == C.Target && Queued.Slot == C.Slot;
+		});
+	}
+	// 中断安全。丢弃目标位于[Begin,End)中的续延，用于进程中止和析构。
+	static void Cancel(void const* Begin, void const* End) {
+		_Cancel([Begin = reinterpret_cast<uintptr_t>(Begin), End = reinterpret_cast<uintptr_t>(End)](Continuation const& Queued) {
+			uintptr_t const Target = reinterpret_cast<uintptr_t>(Queued.Target);
+			return Target >= Begin && Target < End;
+		});
+	}
+	// 自启动以来单级队列的最大长度
+	static uint8_t HighWater;
+	// 因队列已满而在中断中就地执行的续延数
+	static uint16_t Overflows;
+
+protected:
+	struct _Entry {
+		Continuation Target;
+#ifdef GBEC_COUNT_ALLOCATIONS
+		// 入队时的分配归属，执行时恢复
+		_AllocationOwner Owner;
+#endif
+	};
+	struct _Ring {
+		_Entry Entries[GBEC_RUN_QUEUE_CAPACITY];
+		uint8_t Head = 0;
+		uint8_t Size = 0;
+	};
+	static _Ring Queues[NumPriorities];
+	// 被丢弃的续延只清空目标，出队时什么也不做
+	template<typename Predicate>
+	static void _Cancel(Predicate Match) {
+		Quick_digital_IO_interrupt::InterruptGuard const _;
+		for (_Ring& Q : Queues)
+			for (uint8_t I = 0; I < Q.Size; ++I) {
+				Continuation& Queued = Q.Entries[(Q.Head + I) % GBEC_RUN_QUEUE_CAPACITY].Target;
+				if (Match(Queued))
+					Queued.Target = nullptr;
+			}
+	}
+};
+#endif
+// 断点的容量，单位字节。会话所需超出此值时编译失败。可在包含本头文件前定义此宏以覆盖默认值。
+#ifndef GBEC_CHECKPOINT_CAPACITY
+#define GBEC_CHECKPOINT_CAPACITY 32
+#endif
+static_assert(GBEC_CHECKPOINT_CAPACITY <= UINT8_MAX, "GBEC_CHECKPOINT_CAPACITY不能超过255");
+// 断点：前台执行路径上各模块位置的紧凑记录，由SaveCheckpoint依次写入，StartFrom按相同顺序读出。读完之后只得到0，相当于从头开始。
+struct Checkpoint {
+	uint8_t Size = 0;
+	uint8_t Position = 0;
+	// 有字节因容量不足未能写入，此断点不完整，不能使用
+	bool Overflowed = false;
+	uint8_t Bytes[GBEC_CHECKPOINT_CAPACITY];
+	// 执行路径之前的字节：随机种子、抽取次数和入口模块的剩余次数
+	static constexpr uint8_t HeaderBytes = sizeof(uint32_t) * 2 + sizeof(uint16_t);
+	// 容量不足时不写入并设置Overflowed，返回是否写入
+	template<typename T>
+	bool Put(T Value) {
+		if (Size + sizeof(T) > sizeof(Bytes)) {
+			Overflowed = true;
+			return false;
+		}
+		memcpy(Bytes + Size, &Value, sizeof(T));
+		Size += sizeof(T);
+		return true;
+	}
+	template<typename T>
+	T Get() {
+		T Value{};
+		if (Position + sizeof(T) <= Size) {
+			memcpy(&Value, Bytes + Position, sizeof(T));
+			Position += sizeof(T);
+		}
+		return Value;
+	}
+};
+// 所有模块的基类，本身可以当作一个什么都不做的空模块使用
+struct Module : IInformative, IResumable {
+	Process& Container;
+	constexpr Module(Process& Container)
+		: Container(Container) {
+	}
+	// 返回是否需要等待回调，并提供回调续延。返回true表示模块还在执行中，将在执行完毕后调用FinishCallback；返回false表示模块已执行完毕，不会调用FinishCallback。
+	virtual bool Start(Continuation FinishCallback) {
+		return false;
+	}
+	// 子模块执行完毕后经由续延回到此处。容器模块覆盖此方法以推进到下一步。
+	void Resume(uint8_t Slot) override {}
+	// 放弃该模块。未在执行的步骤放弃也不会出错。但不会调用FinishCallback。
+	virtual void Abort() {}
+
+	// 重新开始当前执行中的步骤，不改变下一步。重启已结束的模块，本次执行结束后也会继续调用上次Start设置的下一步。
+	virtual void Restart() {}
+
+	// 将模块在前台执行路径上的位置写入断点，并递归写入当前执行的子模块。默认不记录位置。写入的字节数不能超过CheckpointBytes。
+	virtual void SaveCheckpoint(Checkpoint& C) const {}
+	// 按SaveCheckpoint写入的顺序读出断点，从该位置继续执行，返回值含义同Start。默认从头执行。
+	virtual bool StartFrom(Checkpoint& C, Continuation FinishCallback) {
+		return Start(FinishCallback);
+	}
+
+	// 注意模块析构时不Abort。模块的Abort只由ModuleAbort步骤负责调用。
+	static constexpr uint16_t NumTrials = 0;
+
+protected:
+	// 计时器库要求以std::move_only_function提供回调。此类只捕获一个指针，构造一次后不再改写，不会分配内存。
+	template<typename M>
+	struct _EmptyStart {
+		M* const ContentModule;
+		void operator()() const;
+	};
+};
+
+// 仅在LoadModule时用作重载提示，无定义
+template<UID ID>
+struct IDModule;
+template<typename M>
+struct _IDModule {
+	using type = M;
+};
+template<typename M>
+using _IDModule_t = typename _IDModule<M>::type;
+
+// 调用子模块。定义GBEC_STATIC_DISPATCH时按子模块的实际类型限定调用，不经虚表，编译器可以把整条模块链内联展开；否则照常虚调用。
+// Child的静态类型必须就是其实际类型，LoadModule返回的指针满足这一点。需要运行时间接的地方（进程入口、DynamicSlot的内容、续延）仍经虚表。
+template<typename M>
+inline bool _StartChild(M* Child, Continuation FC) {
+#ifdef GBEC_STATIC_DISPATCH
+	return Child->M::Start(FC);
+#else
+	return Child->Start(FC);
+#endif
+}
+template<typename M>
+inline void _AbortChild(M* Child) {
+#ifdef GBEC_STATIC_DISPATCH
+	Child->M::Abort();
+#else
+	Child->Abort();
+#endif
+}
+template<typename M>
+inline void _RestartChild(M* Child) {
+#ifdef GBEC_STATIC_DISPATCH
+	Child->M::Restart();
+#else
+	Child->Restart();
+#endif
+}
+template<typename M>
+void Module::_EmptyStart<M>::operator()() const {
+	GBEC_TIMER_ISR_SCOPE();
+	GBEC_ALLOCATION_SCOPE(ContentModule->Container, ContentModule);
+	EventClock::Unpinned const Unpinned;
+	_StartChild(ContentModule, Continuation{});
+}
+
+template<typename T>
+struct _TypeID {
+	static constexpr UID value = UID::Type_Pointer;
+};
+template<>
+struct _TypeID<std::chrono::seconds> {
+	static constexpr UID value = UID::Type_Seconds;
+};
+template<>
+struct _TypeID<std::chrono::milliseconds> {
+	static constexpr UID value = UID::Type_Milliseconds;
+};
+template<>
+struct _TypeID<std::chrono::microseconds> {
+	static constexpr UID value = UID::Type_Microseconds;
+};
+template<>
+struct _TypeID<UID> {
+	static constexpr UID value = UID::Type_UID;
+};
+template<>
+struct _TypeID<uint8_t> {
+	static constexpr UID value = UID::Type_UInt8;
+};
+template<>
+struct _TypeID<uint16_t> {
+	static constexpr UID value = UID::Type_UInt16;
+};
+template<>
+struct _TypeID<uint32_t> {
+	static constexpr UID value = UID::Type_UInt32;
+};
+template<>
+struct _TypeID<bool> {
+	static constexpr UID value = UID::Type_Bool;
+};
+#pragma pack(push, 1)
+template<typename T>
+struct PodField {
+	UID const FieldName;
+	UID const FieldType;
+	T FieldValue;
+	constexpr PodField(UID FieldName, T FieldValue)
+		: FieldName(FieldName), FieldType(_TypeID<T>::value), FieldValue(FieldValue) {
+	}
+	constexpr PodField(UID FieldName, UID FieldType, T FieldValue)
+		: FieldName(FieldName), FieldType(FieldType), FieldValue(FieldValue) {
+	}
+};
+#pragma pack(pop)
+
+// 单个批量事件报文最多容纳的事件数，可在包含本头文件前定义此宏以覆盖默认值
+#ifndef GBEC_EVENT_BATCH_CAPACITY
+#define GBEC_EVENT_BATCH_CAPACITY 16
+#endif
+
+// 单个会话的内存预算，单位字节。SessionBudget的估计超出此值时编译失败。可在包含本头文件前定义此宏以覆盖默认值，须为串口缓冲、监听器和栈留出余量。
+#ifndef GBEC_SESSION_RAM_BUDGET
+#ifdef ARDUINO_ARCH_AVR
+#define GBEC_SESSION_RAM_BUDGET 4096
+#endif
+#ifdef ARDUINO_ARCH_SAM
+#define GBEC_SESSION_RAM_BUDGET 32768
+#endif
+#endif
+// Timers_one_for_all.hpp中启用的硬件计时器数。在条件块外声明，覆盖GBEC_SESSION_TIMER_BUDGET的宏也可引用它
+constexpr uint8_t _NumTimers = 0
+#ifdef TOFA_TIMER0
+                               + 1
+#endif
+#ifdef TOFA_TIMER1
+                               + 1
+#endif
+#ifdef TOFA_TIMER2
+                               + 1
+#endif
+#ifdef TOFA_TIMER3
+                               + 1
+#endif
+#ifdef TOFA_TIMER4
+                               + 1
+#endif
+#ifdef TOFA_TIMER5
+                               + 1
+#endif
+#ifdef TOFA_TIMER6
+                               + 1
+#endif
+#ifdef TOFA_TIMER7
+                               + 1
+#endif
+#ifdef TOFA_TIMER8
+                               + 1
+#endif
+#ifdef TOFA_REALTIMER
+                               + 1
+#endif
+#ifdef TOFA_SYSTIMER
+                               + 1
+#endif
+  ;
+// 单个会话可用的硬件计时器数，默认为启用的计时器数减去SoftTimer保留的一个
+#ifndef GBEC_SESSION_TIMER_BUDGET
+#define GBEC_SESSION_TIMER_BUDGET (_NumTimers - 1)
+#endif
+/* 将短时间内产生的事件合并为一个发往PortC_SignalBatch的紧凑报文，以摊薄每个报文的帧头开销。报文内容是若干个紧密排列的Record，不带返回端口号。每个Record用8位进程句柄代替进程指针，并带有事件产生时的EventClock时间戳。
+批中最早的事件等待超过WindowMilliseconds，或事件数达到MaxRecords时，整批发出。其它向主机报告进程状态的报文发出前必须先调用Flush，以免事件与回合开始、进程结束的先后顺序错乱。
+*/
+struct EventBatch {
+#pragma pack(push, 1)
+	struct Record {
+		uint8_t ProcessHandle;
+		UID Event;
+		uint32_t Micros;
+	};
+#pragma pack(pop)
+	// 0表示不合并，每个事件单独成批
+	static uint16_t WindowMilliseconds;
+	// 不能为0，也不能超过GBEC_EVENT_BATCH_CAPACITY
+	static uint8_t MaxRecords;
+	// 在中断中发出时因发送缓冲区已满而整批丢弃的批数，饱和不回绕
+	static uint16_t DroppedBatches;
+
+	// 中断安全
+	static void Push(uint8_t ProcessHandle, UID Event) {
+		bool const ThreadContext = Async_stream_IO::InterruptGuard::ThreadContext();
+		Record Taken[GBEC_EVENT_BATCH_CAPACITY];
+		uint8_t NumTaken;
+		{
+			Quick_digital_IO_interrupt::InterruptGuard const _;
+			if (!Count)
+				FirstMillis = millis();
+			Records[Count++] = { ProcessHandle, Event, EventClock::Now() };
+			if (Count < MaxRecords && WindowMilliseconds)
+				return;
+			if (!ThreadContext) {
+				_SendInPlace();
+				return;
+			}
+			NumTaken = _Take(Taken);
+		}
+		_Send(Taken, NumTaken);
+	}
+	/* 中断安全。在主线程语境中，先禁用中断取出整批，再启用中断发送，发送缓冲区已满时等待其发出；在中断中不能等待，只能就地发送，发送缓冲区已满时整批丢弃。
+	必须在禁用中断之前判断语境，否则主线程语境也会被当作中断而丢弃。
+	*/
+	static void Flush() {
+		if (Async_stream_IO::InterruptGuard::ThreadContext()) {
+			Record Taken[GBEC_EVENT_BATCH_CAPACITY];
+			uint8_t NumTaken;
+			{
+				Quick_digital_IO_interrupt::InterruptGuard const _;
+				NumTaken = _Take(Taken);
+			}
+			_Send(Taken, NumTaken);
+		} else {
+			Quick_digital_IO_interrupt::InterruptGuard const _;
+			_SendInPlace();
+		}
+	}
+	// 应在loop中调用，发出等待超过时间窗口的批
+	static void Poll() {
+		bool Due;
+		{
+			Quick_digital_IO_interrupt::InterruptGuard const _;
+			Due = Count && millis() - FirstMillis >= WindowMilliseconds;
+		}
+		if (Due)
+			Flush();
+	}
+
+protected:
+	static Record Records[GBEC_EVENT_BATCH_CAPACITY];
+	static uint8_t Count;
+	static uint32_t FirstMillis;
+	// 必须在禁用中断时调用
+	static uint8_t _Take(Record* Out) {
+		uint8_t const N = Count;
+		std::copy_n(Records, N, Out);
+		Count = 0;
+		return N;
+	}
+	// 必须在禁用中断时调用
+	static void _SendInPlace() {
+		_Send(Records, Count);
+		Count = 0;
+	}
+	// 在主线程语境中调用时，发送缓冲区已满将等待；在中断或禁用中断时调用，则整批丢弃
+	static void _Send(Record const* Batch, uint8_t N) {
+		if (!N)
+			return;
+		Async_stream_IO::AsyncStream::SendSession const Session = SerialStream.BeginCompactSend(sizeof(Record) * N, static_cast<Async_stream_IO::Port>(UID::PortC_SignalBatch));
+		if (SerialStream.Discarding()) {
+			if (DroppedBatches < UINT16_MAX)
+				++DroppedBatches;
+			return;
+		}
+		SerialStream.Write(reinterpret_cast<byte const*>(Batch), sizeof(Record) * N);
+	}
+	static_assert(sizeof(Record) * GBEC_EVENT_BATCH_CAPACITY <= 255, "批量事件报文超过紧凑报文的长度上限");
+};
+// 一个模块的编译期信息在闪存中的位置和长度
+struct _InfoEntry {
+	void const* Data;
+	Async_stream_IO::MessageSize Size;
+};
+// 模块的InfoStruct在闪存中的唯一实例，同类型的模块在所有会话间共用
+template<typename M>
+struct _InfoBlob {
+	static constexpr typename M::InfoStruct Value PROGMEM = {};
+};
+// 一个会话所有模块在场地中的布局，由入口模块的类型图在编译期生成
+struct _ModuleTable {
+	uint8_t NumModules;
+	// 场地总字节数，包括模块之后的回合计数和末尾每个模块1字节的已构造标志
+	uint16_t Footprint;
+	uint16_t const* Offsets;
+	// 按实际类型析构场地中的模块。平凡析构的模块为nullptr。
+	void (*const* Destructors)(void*);
+	// 各模块的信息，存放在闪存中，整条读出后才能使用
+	_InfoEntry const* Infos;
+	UID const* const* IDs;
+	// 会话中出现的各回合ID，不重复。回合计数在场地中与之一一对应。
+	uint8_t NumTrialIDs;
+	UID const* TrialIDs;
+	uint16_t TrialsDoneOffset;
+};
+// 模块类型在正在载入的会话布局中的序号，由LoadStartModule按编译期布局写入，构造完毕后复位为UINT8_MAX。每个模块类型占1字节内存，换取LoadModule的常数时间查找，并能识别布局中遗漏的类型。
+template<typename M>
+struct _LayoutSlot {
+	static uint8_t Index;
+};
+template<typename M>
+uint8_t _LayoutSlot<M>::Index = UINT8_MAX;
+namespace detail {
+	template<typename... Ts>
+	struct type_list {
+	};
+
+	template<typename A, typename B>
+	struct concat;
+	template<typename... A, typename... B>
+	struct concat<type_list<A...>, type_list<B...>> {
+		using type = type_list<A..., B...>;
+	};
+
+	template<typename T, typename List>
+	struct contains;
+	template<typename T, typename... Ts>
+	struct contains<T, type_list<Ts...>> : std::disjunction<std::is_same<T, Ts>...> {
+	};
+
+	// 模块通过LoadModule加载的子模块。默认取模块的类型模板参数，其中非模块的类型（如时间单位、Infinite）会在收集时被忽略。无法从模板参数推断的模块（如嵌套模板）应自行声明Dependencies类型列表。
+	template<typename M>
+	struct template_arguments {
+		using type = type_list<>;
+	};
+	template<template<typename...> class M, typename... Args>
+	struct template_arguments<M<Args...>> {
+		using type = type_list<Args...>;
+	};
+	template<template<UID, typename...> class M, UID ID, typename... Args>
+	struct template_arguments<M<ID, Args...>> {
+		using type = type_list<Args...>;
+	};
+	template<template<uint8_t, typename...> class M, uint8_t Pin, typename... Args>
+	struct template_arguments<M<Pin, Args...>> {
+		using type = type_list<Args...>;
+	};
+	template<typename M, typename = void>
+	struct module_dependencies : template_arguments<M> {
+	};
+	template<typename M>
+	struct module_dependencies<M, std::void_t<typename M::Dependencies>> {
+		using type = typename M::Dependencies;
+	};
+
+	// 从Pending出发深度优先收集所有模块，跳过Visited中已有的，以支持循环引用
+	template<typename Visited, typename... Pending>
+	struct collect_modules {
+		using type = Visited;
+	};
+	template<typename Visited, typename Dependencies, typename... Pending>
+	struct collect_after;
+	template<typename Visited, typename... Dependencies, typename... Pending>
+	struct collect_after<Visited, type_list<Dependencies...>, Pending...> : collect_modules<Visited, Dependencies..., Pending...> {
+	};
+	template<typename Visited, typename Head, typename... Pending>
+	struct collect_modules<Visited, Head, Pending...> {
+		using _Head = _IDModule_t<Head>;
+		using type = typename std::conditional_t<
+			!std::is_base_of<IInformative, _Head>::value || contains<_Head, Visited>::value,
+			collect_modules<Visited, Pending...>,
+			collect_after<typename concat<Visited, type_list<_Head>>::type, typename module_dependencies<_Head>::type, Pending...>>::type;
+	};
+
+	template<typename M, typename = void>
+	struct background_modules {
+		using type = type_list<>;
+	};
+	template<typename M>
+	struct background_modules<M, std::void_t<typename M::BackgroundModules>> {
+		using type = typename M::BackgroundModules;
+	};
+	template<typename... Lists>
+	struct concat_all {
+		using type = type_list<>;
+	};
+	template<typename Head, typename... Tail>
+	struct concat_all<Head, Tail...> : concat<Head, typename concat_all<Tail...>::type> {
+	};
+	// 去除重复的模块
+	template<typename Visited, typename... Pending>
+	struct unique_modules {
+		using type = Visited;
+	};
+	template<typename Visited, typename Head, typename... Pending>
+	struct unique_modules<Visited, Head, Pending...>
+	  : unique_modules<std::conditional_t<contains<_IDModule_t<Head>, Visited>::value, Visited, typename concat<Visited, type_list<_IDModule_t<Head>>>::type>, Pending...> {
+	};
+	template<typename List>
+	struct sum_timers;
+	template<typename... Ms>
+	struct sum_timers<type_list<Ms...>> {
+		static constexpr size_t value = (size_t(0) + ... + Ms::MaxTimers);
+	};
+	template<typename List>
+	struct unique_list;
+	template<typename... Ms>
+	struct unique_list<type_list<Ms...>> : unique_modules<type_list<>, Ms...> {
+	};
+
+	// 模块是否为回合及其回合ID，由Trial特化
+	template<typename M>
+	struct trial_id {
+		static constexpr bool is_trial = false;
+		static constexpr UID value{};
+	};
+	template<typename M>
+	void destroy_module(void* At) {
+		static_cast<M*>(At)->~M();
+	}
+	template<typename List>
+	struct module_layout;
+	template<typename... Ms>
+	struct module_layout<type_list<Ms...>> {
+		struct Offsets_t {
+			uint16_t Values[sizeof...(Ms)];
+			size_t End;
+		};
+		static constexpr Offsets_t ComputeOffsets() {
+			constexpr size_t Sizes[] = { sizeof(Ms)... };
+			constexpr size_t Alignments[] = { alignof(Ms)... };
+			Offsets_t Offsets{};
+			for (size_t M = 0; M < sizeof...(Ms); ++M) {
+				Offsets.End = (Offsets.End + Alignments[M] - 1) / Alignments[M] * Alignments[M];
+				Offsets.Values[M] = Offsets.End;
+				Offsets.End += Sizes[M];
+			}
+			return Offsets;
+		}
+		static constexpr Offsets_t Offsets = ComputeOffsets();
+		struct TrialIDs_t {
+			UID Values[sizeof...(Ms)];
+			uint8_t Count;
+		};
+		static constexpr TrialIDs_t ComputeTrialIDs() {
+			constexpr bool IsTrial[] = { trial_id<Ms>::is_trial... };
+			constexpr UID Candidates[] = { trial_id<Ms>::value... };
+			TrialIDs_t TrialIDs{};
+			for (size_t M = 0; M < sizeof...(Ms); ++M)
+				if (IsTrial[M]) {
+					uint8_t T = 0;
+					while (T < TrialIDs.Count && TrialIDs.Values[T] != Candidates[M])
+						++T;
+					if (T == TrialIDs.Count)
+						TrialIDs.Values[TrialIDs.Count++] = Candidates[M];
+				}
+			return TrialIDs;
+		}
+		static constexpr TrialIDs_t TrialIDs = ComputeTrialIDs();
+		static constexpr size_t TrialsDoneOffset = (Offsets.End + alignof(uint16_t) - 1) / alignof(uint16_t) * alignof(uint16_t);
+		// 所有模块、回合计数及已构造标志的总字节数
+		static constexpr size_t Footprint = TrialsDoneOffset + sizeof(uint16_t) * TrialIDs.Count + sizeof...(Ms);
+		static_assert(sizeof...(Ms) <= 255, "会话的模块数超过255");
+		static_assert(Footprint <= UINT16_MAX, "会话的模块总大小超过64KB");
+		static constexpr void (*Destructors[])(void*) = { std::is_trivially_destructible<Ms>::value ? nullptr : &destroy_module<Ms>... };
+		static constexpr _InfoEntry Infos[] PROGMEM = { { &_InfoBlob<Ms>::Value, sizeof(_InfoBlob<Ms>::Value) }... };
+		static UID const* const IDs[sizeof...(Ms)];
+		static constexpr _ModuleTable Table{ sizeof...(Ms), Footprint, Offsets.Values, Destructors, Infos, IDs, TrialIDs.Count, TrialIDs.Values, TrialsDoneOffset };
+		static constexpr size_t HeapBytes = (size_t(0) + ... + Ms::HeapBytes);
+		static void BindSlots() {
+			_BindSlots(std::index_sequence_for<Ms...>{});
+		}
+		static void UnbindSlots() {
+			((_LayoutSlot<Ms>::Index = UINT8_MAX), ...);
+		}
+		template<size_t... Indices>
+		static void _BindSlots(std::index_sequence<Indices...>) {
+			((_LayoutSlot<Ms>::Index = Indices), ...);
+		}
+		// 所有可能在后台执行的模块各自所需的计时器数之和
+		static constexpr size_t BackgroundTimers = sum_timers<typename unique_list<typename concat_all<typename background_modules<Ms>::type...>::type>::type>::value;
+	};
+	template<typename... Ms>
+	UID const* const module_layout<type_list<Ms...>>::IDs[sizeof...(Ms)] = { &_ModuleID<Ms>::ID... };
+}
+// 入口模块Entry及其直接间接加载的所有模块的布局。入口模块总是第0个。
+template<typename Entry>
+using SessionLayout = detail::module_layout<typename detail::collect_modules<detail::type_list<>, Entry>::type>;
+// 会话的编译期资源估计
+template<typename Entry>
+struct SessionBudget {
+	using _Entry = _IDModule_t<Entry>;
+	using _Layout = SessionLayout<_Entry>;
+	// 内存字节数：模块场地（含模块内的回调对象和指针表）及其堆块开销，加上各模块在场地之外可能占用的堆内存
+	static constexpr size_t Ram = _Layout::Footprint + detail::heap_overhead + _Layout::HeapBytes
+#ifdef GBEC_COUNT_ALLOCATIONS
+								  + sizeof(uint16_t[2]) * _Layout::Table.NumModules + detail::heap_overhead
+#endif
+	  ;
+	// 同时占用计时器数的上限：入口模块前台所需，加上所有可能在后台执行的模块各自所需
+	static constexpr size_t Timers = _Entry::MaxTimers + _Layout::BackgroundTimers;
+};
+// 软件计时器：所有实例按到期时刻排成有序单链表，共用Begin保留的一个硬件计时器，硬件计时器只为链表头设定单发中断。接口与Timers_one_for_all::TimerClass一致；毫秒及以上单位的计时模块使用此类，因此并发计时数只受内存限制，不受硬件计时器数限制。
+class SoftTimer {
+public:
+	// 在setup中调用一次，保留调度用的硬件计时器
+	static void Begin() {
+		Hardware = Timers_one_for_all::AllocateTimer();
+	}
+	template<typename T>
+	void DoAfter(T AfterTime, std::move_only_function<void()>& Do) {
+		Quick_digital_IO_interrupt::InterruptGuard const _;
+		_Set(_Micros(AfterTime), &Do, _Micros(AfterTime), &Do, 1, nullptr);
+	}
+	template<typename T>
+	void RepeatEvery(T RepeatInterval, std::move_only_function<void()>& Do) {
+		Quick_digital_IO_interrupt::InterruptGuard const _;
+		_Set(_Micros(RepeatInterval), &Do, _Micros(RepeatInterval), &Do, 0, nullptr);
+	}
+	template<typename T>
+	void RepeatEvery(T RepeatInterval, std::move_only_function<void()>& Do, uint64_t RepeatTimes, std::move_only_function<void()>& DoneCallback) {
+		Quick_digital_IO_interrupt::InterruptGuard const _;
+		if (RepeatTimes)
+			_Set(_Micros(RepeatInterval), &Do, _Micros(RepeatInterval), &Do, RepeatTimes, &DoneCallback);
+		else
+			_Stop();
+	}
+	template<typename T>
+	void DoubleRepeat(T AfterA, std::move_only_function<void()>& DoA, T AfterB, std::move_only_function<void()>& DoB) {
+		Quick_digital_IO_interrupt::InterruptGuard const _;
+		_Set(_Micros(AfterA), &DoA, _Micros(AfterB), &DoB, 0, nullptr);
+	}
+	// RepeatTimes为半周期数
+	template<typename T>
+	void DoubleRepeat(T AfterA, std::move_only_function<void()>& DoA, T AfterB, std::move_only_function<void()>& DoB, uint64_t RepeatTimes, std::move_only_function<void()>& DoneCallback) {
+		Quick_digital_IO_interrupt::InterruptGuard const _;
+		if (RepeatTimes)
+			_Set(_Micros(AfterA), &DoA, _Micros(AfterB), &DoB, RepeatTimes, &DoneCallback);
+		else
+			_Stop();
+	}
+	// 中断安全
+	void Stop() {
+		Quick_digital_IO_interrupt::InterruptGuard const _;
+		_Stop();
+	}
+	// 中断安全。暂停期间Deadline记录剩余时间。
+	void Pause() {
+		Quick_digital_IO_interrupt::InterruptGuard const _;
+		if (Queued) {
+			_Dequeue();
+			uint64_t const Now = _Now();
+			Deadline = Deadline > Now ? Deadline - Now : 0;
+			Paused = true;
+		}
+	}
+	// 中断安全
+	void Continue() {
+		Quick_digital_IO_interrupt::InterruptGuard const _;
+		if (Paused) {
+			Paused = false;
+			Deadline += _Now();
+			_Enqueue();
+		}
+	}
+	// 中断安全。距下次到期的微秒数，未在计时时为0。
+	uint64_t Remaining() const {
+		Quick_digital_IO_interrupt::InterruptGuard const _;
+		if (Paused)
+			return Deadline;
+		if (!Queued)
+			return 0;
+		uint64_t const Now = _Now();
+		return Deadline > Now ? Deadline - Now : 0;
+	}
+
+protected:
+	// 64位微秒时刻，不会回绕
+	uint64_t Deadline;
+	uint64_t Periods[2];
+	std::move_only_function<void()>* Callbacks[2];
+	// 最后一次回调之后调用，可为空
+	std::move_only_function<void()>* DoneCallback;
+	// 剩余回调次数，0表示无限
+	uint64_t TimesLeft;
+	SoftTimer* Next = nullptr;
+	bool Phase;
+	bool Queued = false;
+	bool Paused = false;
+
+	static SoftTimer* Head;
+	static Timers_one_for_all::TimerClass* Hardware;
+	static std::move_only_function<void()> TickCallback;
+	static bool InTick;
+	static uint32_t LastMicros;
+	static uint64_t Epoch;
+
+	// 单次等待的上限。硬件中断至少每隔此时长到来一次，使_Now能够察觉micros()的每次回绕。
+	static constexpr uint64_t MaxWait = 30ull * 60 * 1000000;
+	template<typename T>
+	static uint64_t _Micros(T Duration) {
+		uint64_t const Micros = std::chrono::duration_cast<std::chrono::duration<uint64_t, std::micro>>(Duration).count();
+		return Micros ? Micros : 1;
+	}
+	// 中断不安全
+	static uint64_t _Now() {
+		uint32_t const Micros = micros();
+		if (Micros < LastMicros)
+			Epoch += uint64_t(1) << 32;
+		LastMicros = Micros;
+		return Epoch + Micros;
+	}
+	// 中断不安全
+	void _Set(uint64_t PeriodA, std::move_only_function<void()>* DoA, uint64_t PeriodB, std::move_only_function<void()>* DoB, uint64_t Times, std::move_only_function<void()>* Done) {
+		_Dequeue();
+		Paused = false;
+		Periods[0] = PeriodA;
+		Periods[1] = PeriodB;
+		Callbacks[0] = DoA;
+		Callbacks[1] = DoB;
+		TimesLeft = Times;
+		DoneCallback = Done;
+		Phase = false;
+		Deadline = _Now() + PeriodA;
+		_Enqueue();
+	}
+	// 中断不安全
+	void _Stop() {
+		_Dequeue();
+		Paused = false;
+		DoneCallback = nullptr;
+	}
+	// 中断不安全。同一时刻到期的计时器按入队先后排列。
+	void _Enqueue() {
+		SoftTimer** Link = &Head;
+		while (*Link && (*Link)->Deadline <= Deadline)
+			Link = &(*Link)->Next;
+		Next = *Link;
+		*Link = this;
+		Queued = true;
+		if (Head == this)
+			_Arm();
+	}
+	// 中断不安全。出队链表头时不重设硬件计时器，届时的空转中断无害。
+	void _Dequeue() {
+		if (!Queued)
+			return;
+		SoftTimer** Link = &Head;
+		while (*Link != this)
+			Link = &(*Link)->Next;
+		*Link = Next;
+		Queued = false;
+	}
+	// 在_Tick中调用，中断不安全。先按下一阶段重新入队再调用回调，回调可以自由地停止或重设本计时器。
+	void _Fire() {
+		std::move_only_function<void()>* const Callback = Callbacks[Phase];
+		if (TimesLeft && !--TimesLeft) {
+			if (Callback)
+				(*Callback)();
+			// 回调可能已停止或重设本计时器，此时不再调用原先的DoneCallback
+			if (std::move_only_function<void()>* const Done = DoneCallback; Done && !Queued && !Paused) {
+				DoneCallback = nullptr;
+				(*Done)();
+			}
+		} else {
+			Phase = !Phase;
+			Deadline += Periods[Phase];
+			_Enqueue();
+			if (Callback)
+				(*Callback)();
+		}
+	}
+	// 硬件计时器中断回调：依次触发所有已到期的计时器，然后为新的链表头重设硬件计时器
+	static void _Tick() {
+		GBEC_TIMER_ISR_SCOPE();
+		InTick = true;
+		while (Head && Head->Deadline <= _Now()) {
+			SoftTimer* const Due = Head;
+			Head = Due->Next;
+			Due->Queued = false;
+			Due->_Fire();
+		}
+		InTick = false;
+		_Arm();
+	}
+	// 中断不安全。_Tick期间推迟到其结束时统一设定。
+	static void _Arm() {
+		if (InTick)
+			return;
+		if (Head) {
+			uint64_t const Now = _Now();
+			uint64_t const Wait = Head->Deadline > Now ? std::min(Head->Deadline - Now, MaxWait) : 1;
+			Hardware->DoAfter(std::chrono::microseconds(Wait), TickCallback);
+		} else
+			Hardware->Stop();
+	}
+};
+// 微秒级计时需要硬件计时器的精度，独占一个硬件计时器；毫秒及以上由SoftTimer复用同一个硬件计时器
+template<typename Unit>
+using _TimerFor = std::conditional_t<std::ratio_less<typename Unit::period, std::milli>::value, Timers_one_for_all::TimerClass, SoftTimer>;
+// 侵入式双向循环链表。节点嵌在模块中，登记和注销都不分配堆内存，适合在Start、Restart、Abort和中断回调中使用。
+template<typename T>
+struct _ActiveList {
+	struct Node {
+		T* Value;
+		Node* Previous = nullptr;
+		Node* Next = nullptr;
+		constexpr Node(T* Value = nullptr)
+			: Value(Value) {
+		}
+		// 链表持有节点地址，不能复制
+		Node(Node const&) = delete;
+		Node& operator=(Node const&) = delete;
+	};
+	struct Iterator {
+		Node const* Current;
+		T* operator*() const {
+			return Current->Value;
+		}
+		Iterator& operator++() {
+			Current = Current->Next;
+			return *this;
+		}
+		bool operator!=(Iterator const& Other) const {
+			return Current != Other.Current;
+		}
+	};
+	_ActiveList() {
+		Head.Previous = Head.Next = &Head;
+	}
+	_ActiveList(_ActiveList const&) = delete;
+	// 已登记的节点不会重复登记
+	void insert(Node& N) {
+		if (N.Next)
+			return;
+		N.Previous = Head.Previous;
+		N.Next = &Head;
+		Head.Previous->Next = &N;
+		Head.Previous = &N;
+	}
+	// 注销未登记的节点无效果
+	void erase(Node& N) {
+		if (!N.Next)
+			return;
+		N.Previous->Next = N.Next;
+		N.Next->Previous = N.Previous;
+		N.Previous = N.Next = nullptr;
+	}
+	void clear() {
+		while (Head.Next != &Head)
+			erase(*Head.Next);
+	}
+	Iterator begin() const {
+		return { Head.Next };
+	}
+	Iterator end() const {
+		return { &Head };
+	}
+
+protected:
+	Node Head;
+};
+// 进程独立的xoshiro128**伪随机数发生器，只用32位运算，两种架构上行为完全一致。相同种子产生相同序列，并记录已抽取的次数，主机据此可复现一次会话的全部随机安排，或从中途恢复。
+struct SessionRandom {
+	using result_type = uint32_t;
+	static constexpr result_type min() {
+		return 0;
+	}
+	static constexpr result_type max() {
+		return UINT32_MAX;
+	}
+	// 主机未指定种子时，各进程的种子从此种子源依次派生。由PortA_RandomSeed设置。
+	static uint32_t Source;
+	static uint32_t NextSeed() {
+		return _SplitMix(Source);
+	}
+	// 重新播种并清零抽取计数
+	void seed(uint32_t Seed) {
+		_Seed = Seed;
+		_Draws = 0;
+		for (uint32_t& Word : State)
+			Word = _SplitMix(Seed);
+	}
+	result_type operator()() {
+		uint32_t const Result = _Rotl(State[1] * 5, 7) * 9;
+		uint32_t const T = State[1] << 9;
+		State[2] ^= State[0];
+		State[3] ^= State[1];
+		State[1] ^= State[2];
+		State[0] ^= State[3];
+		State[2] ^= T;
+		State[3] = _Rotl(State[3], 11);
+		++_Draws;
+		return Result;
+	}
+	// 均匀抽取[0,Bound)中的整数，Bound不能为0。标准库的分布和std::shuffle如何消耗随机数由实现决定，各平台可能不同；此处固定为拒绝取模法，同一种子在两种架构上抽得相同的结果和抽取次数。
+	uint32_t Below(uint32_t Bound) {
+		// 2^32 mod Bound。小于它的输出会使取模结果偏向小值，须拒绝重抽
+		uint32_t const Threshold = (uint32_t(0) - Bound) % Bound;
+		uint32_t Result;
+		do
+			Result = operator()();
+		while (Result < Threshold);
+		return Result % Bound;
+	}
+	// 快进到已抽取Draws次的状态。已抽取的次数更多时无效果。
+	void SkipTo(uint32_t Draws) {
+		while (_Draws < Draws)
+			operator()();
+	}
+	constexpr uint32_t Seed() const {
+		return _Seed;
+	}
+	constexpr uint32_t Draws() const {
+		return _Draws;
+	}
+
+protected:
+	uint32_t State[4];
+	uint32_t _Seed = 0;
+	uint32_t _Draws = 0;
+	static constexpr uint32_t _Rotl(uint32_t X, uint8_t K) {
+		return (X << K) | (X >> (32 - K));
+	}
+	static uint32_t _SplitMix(uint32_t& X) {
+		uint32_t Z = X += 0x9e3779b9;
+		Z = (Z ^ (Z >> 16)) * 0x85ebca6b;
+		Z = (Z ^ (Z >> 13)) * 0xc2b2ae35;
+		return Z ^ (Z >> 16);
+	}
+};
+class Process : IResumable {
+	_ActiveList<Timers_one_for_all::TimerClass> ActiveTimers;
+	_ActiveList<SoftTimer> ActiveSoftTimers;
+	// 所有模块共用一块场地，在LoadStartModule中一次分配
+	_ModuleTable const* Table = nullptr;
+	char* Arena = nullptr;
+	// 入口模块的剩余执行次数，0表示未在执行
+	uint16_t TimesLeft = 0;
+	UID const* StartPointer;
+	Module* StartModule;
+#pragma pack(push, 1)
+	struct InfoHeader {
+		uint8_t const NumFields = 4;
+		PodField<UID const*> StartModule;
+		PodField<uint32_t> RandomSeed;
+		PodField<uint32_t> RandomDraws;
+		UID const Field4Name = UID::Field_Modules;
+		UID const Field4Type = UID::Type_Map;
+		uint8_t NumModules;
+		UID const ModuleKeyType = UID::Type_Pointer;
+		UID const ModuleValueType = UID::Type_Struct;
+		constexpr InfoHeader(UID const* StartPointer, SessionRandom const& Rng, uint8_t NumModules)
+			: StartModule{ UID::Field_StartModule, StartPointer }, RandomSeed{ UID::Field_RandomSeed, Rng.Seed() }, RandomDraws{ UID::Field_RandomDraws, Rng.Draws() }, NumModules(NumModules) {
+		}
+	};
+#pragma pack(pop)
+	// 入口模块每次执行完毕后回到此处
+	void Resume(uint8_t) override {
+		GBEC_ALLOCATION_SCOPE(*this, StartModule);
+		while (--TimesLeft)
+			if (StartModule->Start(Continuation{ this }))
+				return;
+		EventBatch::Flush();
+		SerialStream.AsyncInvoke(static_cast<Async_stream_IO::Port>(UID::PortC_ProcessFinished), this);
+	}
+
+	// 中断不安全
+	void _Abort() {
+		for (PinListener* H : ActiveInterrupts)
+			H->Pause();
+		for (Timers_one_for_all::TimerClass* T : ActiveTimers) {
+			T->Stop();
+			T->Allocatable = true;  // 使其可以被重新分配
+		}
+		for (SoftTimer* T : ActiveSoftTimers)
+			T->Stop();
+		for (Continuation const* Cleaner : ExtraCleaners)
+			(*Cleaner)();
+#ifdef GBEC_DEFER_TIMER_CONTINUATIONS
+		RunQueue::Cancel(this, this + 1);
+		if (Arena)
+			RunQueue::Cancel(Arena, Arena + Table->Footprint);
+#endif
+	}
+	template<typename T>
+	auto Construct(T* At) -> decltype(new (At) T(*this)) {
+		new (At) T(*this);
+	}
+	template<typename T>
+	static auto Construct(T* At) -> decltype(new (At) T()) {
+		new (At) T;
+	}
+	// LoadModule遇到布局中没有的模块类型，本次载入失败
+	bool ModuleMissing = false;
+	/*载入失败时丢弃场地。遗漏的模块以占位指针代替，已构造的模块可能持有它，因此不调用任何模块的析构，直接释放场地。
+	模块只在开始执行后才登记中断和计时器，构造期间不登记，因此直接释放不会留下悬空登记，只可能泄漏模块构造时分配的少量堆内存。
+	*/
+	void _DiscardFailedLoad() {
+		operator delete(Arena);
+		Arena = nullptr;
+		StartModule = nullptr;
+		StartPointer = nullptr;
+#ifdef GBEC_COUNT_ALLOCATIONS
+		delete[] ModuleAllocations;
+		ModuleAllocations = nullptr;
+#endif
+	}
+	bool* _Constructed() const {
+		return reinterpret_cast<bool*>(Arena + Table->Footprint - Table->NumModules);
+	}
+	// 各回合ID已完成次数，与Table->TrialIDs一一对应
+	uint16_t* _TrialsDone() const {
+		return reinterpret_cast<uint16_t*>(Arena + Table->TrialsDoneOffset);
+	}
+	// 析构所有已构造的模块并释放场地
+	void _ClearModules() {
+		if (!Arena)
+			return;
+		bool const* const Constructed = _Constructed();
+		for (uint8_t M = 0; M < Table->NumModules; ++M)
+			if (Constructed[M] && Table->Destructors[M])
+				Table->Destructors[M](Arena + Table->Offsets[M]);
+		operator delete(Arena);
+		Arena = nullptr;
+#ifdef GBEC_COUNT_ALLOCATIONS
+		delete[] ModuleAllocations;
+		ModuleAllocations = nullptr;
+#endif
+	}
+#ifdef GBEC_COUNT_ALLOCATIONS
+	// 每个模块的堆分配次数，与场地一同分配。[0]为构造期间，[1]为此后执行期间。
+	uint16_t (*ModuleAllocations)[2] = nullptr;
+	friend struct _AllocationOwner;
+	// Owner必须指向场地内的模块
+	void CountAllocation(void const* Owner, bool Loading) {
+		if (!ModuleAllocations)
+			return;
+		uint16_t const Offset = static_cast<char const*>(Owner) - Arena;
+		uint8_t M = Table->NumModules - 1;
+		while (Table->Offsets[M] > Offset)
+			--M;
+		++ModuleAllocations[M][!Loading];
+	}
+#endif
+
+public:
+	// 事件报文中代替进程指针的8位句柄，由创建者分配
+	uint8_t Handle;
+	// 本进程所有随机模块共用的发生器，必须在LoadStartModule之前播种，因为模块构造时就会抽取
+	SessionRandom Rng;
+	_ActiveList<PinListener> ActiveInterrupts;
+	void Pause() const {
+#ifdef GBEC_DEFER_TIMER_CONTINUATIONS
+		// 已到期的续延先执行完，与在中断中就地执行时的效果一致
+		RunQueue::Drain();
+#endif
+		for (PinListener* H : ActiveInterrupts)
+			H->Pause();
+		for (Timers_one_for_all::TimerClass* T : ActiveTimers)
+			T->Pause();
+		for (SoftTimer* T : ActiveSoftTimers)
+			T->Pause();
+	}
+	void Continue() const {
+		for (PinListener* H : ActiveInterrupts)
+			H->Continue();
+		for (Timers_one_for_all::TimerClass* T : ActiveTimers)
+			T->Continue();
+		for (SoftTimer* T : ActiveSoftTimers)
+			T->Continue();
+	}
+	void Abort() {
+		_Abort();
+		ActiveInterrupts.clear();
+		ActiveTimers.clear();
+		ActiveSoftTimers.clear();
+		TimesLeft = 0;
+		if (Arena)
+			std::fill_n(_TrialsDone(), Table->NumTrialIDs, 0);
+		ExtraCleaners.clear();
+	}
+	virtual ~Process() {
+		_Abort();
+		_ClearModules();
+	}
+	using TimerNode = _ActiveList<Timers_one_for_all::TimerClass>::Node;
+	// 分配计时器并登记在Registration中
+	Timers_one_for_all::TimerClass* AllocateTimer(TimerNode& Registration) {
+		Registration.Value = Timers_one_for_all::AllocateTimer();
+		ActiveTimers.insert(Registration);
+		return Registration.Value;
+	}
+	// 此操作不负责停止计时器，仅使其可以被再分配
+	void UnregisterTimer(TimerNode& Registration) {
+		ActiveTimers.erase(Registration);
+		Registration.Value->Allocatable = true;
+	}
+	using SoftTimerNode = _ActiveList<SoftTimer>::Node;
+	// 软件计时器嵌在模块中，无需分配，只登记
+	SoftTimer* AllocateTimer(SoftTimerNode& Registration) {
+		ActiveSoftTimers.insert(Registration);
+		return Registration.Value;
+	}
+	void UnregisterTimer(SoftTimerNode& Registration) {
+		ActiveSoftTimers.erase(Registration);
+	}
+	/*只能在LoadStartModule构造模块期间调用。ModuleType必须在入口模块的类型图中，参见detail::module_dependencies。
+	类型图在编译期由模块类型推断，而本方法由模块构造时调用，无从得知所属会话，因此遗漏只能在运行时发现：此时返回不可使用的占位指针，LoadStartModule将载入失败。
+	*/
+	template<typename ModuleType>
+	_IDModule_t<ModuleType>* LoadModule() {
+		using _ModuleType = _IDModule_t<ModuleType>;
+		uint8_t const M = _LayoutSlot<_ModuleType>::Index;
+		if (M == UINT8_MAX) {
+			ModuleMissing = true;
+			return reinterpret_cast<_ModuleType*>(Arena);
+		}
+		_ModuleType* const Pointer = reinterpret_cast<_ModuleType*>(Arena + Table->Offsets[M]);
+		bool& Constructed = _Constructed()[M];
+		if (!Constructed) {
+			//必须先占位后构造，以免递归构造自身
+			Constructed = true;
+			GBEC_ALLOCATION_SCOPE(*this, Pointer, true);
+			Construct(Pointer);
+		}
+		return Pointer;
+	}
+	// 只能在LoadStartModule构造模块期间调用。返回回合ID在计数表中的位置，相同ID的回合共用一个位置。
+	uint8_t TrialSlot(UID TrialID) const {
+		uint8_t T = 0;
+		while (Table->TrialIDs[T] != TrialID)
+			++T;
+		return T;
+	}
+	// 已完成但尚未跳过的回合次数，断点续传时由SetTrialsDone写入，每跳过一个回合减1
+	uint16_t& TrialsDone(uint8_t Slot) const {
+		return _TrialsDone()[Slot];
+	}
+	// 设置指定回合ID的已完成次数。当前会话中没有此ID时忽略并返回false。
+	bool SetTrialsDone(UID TrialID, uint16_t Times) {
+		if (!Arena)
+			return false;
+		for (uint8_t T = 0; T < Table->NumTrialIDs; ++T)
+			if (Table->TrialIDs[T] == TrialID) {
+				_TrialsDone()[T] = Times;
+				return true;
+			}
+		return false;
+	}
+
+	/*此方法会终止并清空当前执行的所有模块（通过清理资源的方法，不调用模块Abort，但会调用清理模块），然后再开始新的模块。返回会话设计的回合数。
+	会话的类型图遗漏了被加载的模块时载入失败，进程不含任何模块，Loaded返回false。通常是自定义模块缺少Dependencies声明。
+	*/
+	template<typename Entry>
+	uint16_t LoadStartModule() {
+
+		using _Entry = _IDModule_t<Entry>;
+		using Layout = SessionLayout<_Entry>;
+		Abort();
+		_ClearModules();
+		Table = &Layout::Table;
+		Arena = static_cast<char*>(operator new(Layout::Footprint));
+		std::fill_n(_Constructed(), Layout::Table.NumModules, false);
+		std::fill_n(_TrialsDone(), Layout::Table.NumTrialIDs, 0);
+#ifdef GBEC_COUNT_ALLOCATIONS
+		ModuleAllocations = new uint16_t[Layout::Table.NumModules][2]();
+#endif
+		StartPointer = &_ModuleID<_Entry>::ID;
+		ModuleMissing = false;
+		Layout::BindSlots();
+		StartModule = LoadModule<_Entry>();
+		Layout::UnbindSlots();
+		if (ModuleMissing) {
+			_DiscardFailedLoad();
+			return 0;
+		}
+		return _Entry::NumTrials;
+	}
+	// 最近一次LoadStartModule是否成功
+	bool Loaded() const {
+		return Arena;
+	}
+
+	bool Start(uint16_t Times) {
+		GBEC_ALLOCATION_SCOPE(*this, StartModule);
+		for (TimesLeft = Times; TimesLeft > 0; --TimesLeft) {
+			if (StartModule->Start(Continuation{ this }))
+				return true;
+		}
+		return false;
+	}
+	// 写入入口模块的剩余次数及其执行路径。中断不安全。
+	void SaveCheckpoint(Checkpoint& C) const {
+		C.Put(TimesLeft);
+		if (TimesLeft)
+			StartModule->SaveCheckpoint(C);
+	}
+	// 从断点继续执行，返回值含义同Start。必须先载入与断点相同的会话。
+	bool StartFrom(Checkpoint& C) {
+		GBEC_ALLOCATION_SCOPE(*this, StartModule);
+		TimesLeft = C.Get<uint16_t>();
+		if (!TimesLeft)
+			return false;
+		if (StartModule->StartFrom(C, Continuation{ this }))
+			return true;
+		while (--TimesLeft)
+			if (StartModule->Start(Continuation{ this }))
+				return true;
+		return false;
+	}
+	// 发送当前或上一个执行模块及其关联模块的所有信息
+	// 信息分块发送：先发信息头，再每个模块一个报文，最后以一个空报文标记结束。每个报文的会话结束后中断即恢复，不会因整个信息过长而长时间阻塞中断，总长度也不受单个报文长度上限的限制。
+	void SendInfo(Async_stream_IO::Port Port) const {
+		if (!Arena) {
+			SerialStream.Send(InfoHeader(nullptr, Rng, 0), Port);
+			SerialStream.Send(nullptr, 0, Port);
+			return;
+		}
+		bool const* const Constructed = _Constructed();
+		SerialStream.Send(InfoHeader(StartPointer, Rng, std::count(Constructed, Constructed + Table->NumModules, true)), Port);
+		for (uint8_t M = 0; M < Table->NumModules; ++M)
+			if (Constructed[M]) {
+				_InfoEntry Info;
+				memcpy_P(&Info, Table->Infos + M, sizeof(Info));
+				Async_stream_IO::AsyncStream::SendSession const _ = SerialStream.BeginSend(sizeof(UID const*) + Info.Size, Port);
+				SerialStream << Table->IDs[M];
+				SerialStream.WriteFlash(static_cast<byte const*>(Info.Data), Info.Size);
+			}
+		SerialStream.Send(nullptr, 0, Port);
+	}
+#ifdef GBEC_COUNT_ALLOCATIONS
+	// 返回第Index个模块的ID并输出其分配计数，Index越界时返回nullptr。中断不安全。
+	UID const* ModuleAllocation(uint8_t Index, uint16_t& Load, uint16_t& Run) const {
+		if (!ModuleAllocations || Index >= Table->NumModules)
+			return nullptr;
+		Load = ModuleAllocations[Index][0];
+		Run = ModuleAllocations[Index][1];
+		return Table->IDs[Index];
+	}
+#endif
+	_ActiveList<Continuation const> ExtraCleaners;
+};
+#ifdef GBEC_COUNT_ALLOCATIONS
+inline void _AllocationOwner::Count() {
+	if (Current.Container)
+		Current.Container->CountAllocation(Current.Owner, Current.Loading);
+}
+#endif
+struct IRandom {
+	virtual void Randomize() = 0;
+};
+template<uint16_t...>
+struct _Sum {
+	static constexpr uint16_t value = 0;
+};
+template<uint16_t First, uint16_t... Rest>
+struct _Sum<First, Rest...> {
+	static constexpr uint16_t value = First + _Sum<Rest...>::value;
+};
+template<size_t...>
+struct _Max {
+	static constexpr size_t value = 0;
+};
+template<size_t First, size_t... Rest>
+struct _Max<First, Rest...> {
+	static constexpr size_t value = First > _Max<Rest...>::value ? First : _Max<Rest...>::value;
+};
+// 一组子模块，按序号调用。定义GBEC_STATIC_DISPATCH时保存各子模块的实际类型指针，按序号展开为对应类型的直接调用；否则保存Module*数组，经虚表调用。
+template<typename... SubModules>
+struct _Children {
+	static constexpr uint8_t Count = sizeof...(SubModules);
+	static_assert(sizeof...(SubModules) <= UINT8_MAX, "子模块过多");
+	_Children(Process& Container)
+		: Pointers{ Container.LoadModule<SubModules>()... } {
+	}
+	bool Start(uint8_t Index, Continuation FC) const {
+#ifdef GBEC_STATIC_DISPATCH
+		return _Visit(Index, [FC](auto* Child) { return _StartChild(Child, FC); }, std::index_sequence_for<SubModules...>{});
+#else
+		return Pointers[Index]->Start(FC);
+#endif
+	}
+	void Abort(uint8_t Index) const {
+#ifdef GBEC_STATIC_DISPATCH
+		_Visit(Index, [](auto* Child) { _AbortChild(Child); return false; }, std::index_sequence_for<SubModules...>{});
+#else
+		Pointers[Index]->Abort();
+#endif
+	}
+	// 断点操作不在热路径上，一律经虚表
+	void SaveCheckpoint(uint8_t Index, Checkpoint& C) const {
+#ifdef GBEC_STATIC_DISPATCH
+		_Visit(Index, [&C](auto* Child) { Child->SaveCheckpoint(C); return false; }, std::index_sequence_for<SubModules...>{});
+#else
+		Pointers[Index]->SaveCheckpoint(C);
+#endif
+	}
+	bool StartFrom(uint8_t Index, Checkpoint& C, Continuation FC) const {
+#ifdef GBEC_STATIC_DISPATCH
+		return _Visit(Index, [&C, FC](auto* Child) { return Child->StartFrom(C, FC); }, std::index_sequence_for<SubModules...>{});
+#else
+		return Pointers[Index]->StartFrom(C, FC);
+#endif
+	}
+	// 从断点恢复时，重新执行序号在Before之前、ReplayOnResume的子模块
+	void Replay(uint8_t Before) const {
+		_Replay(Before, std::index_sequence_for<SubModules...>{});
+	}
+	// 同上，但只针对序号为Index的子模块，用于执行顺序与序号不一致的容器
+	void ReplayAt(uint8_t Index) const {
+		_ReplayAt(Index, std::index_sequence_for<SubModules...>{});
+	}
+
+protected:
+	template<size_t... Indices>
+	void _Replay(uint8_t Before, std::index_sequence<Indices...>) const {
+		(void)((Indices < Before && _IDModule_t<SubModules>::ReplayOnResume && Start(Indices, Continuation{})), ...);
+	}
+	template<size_t... Indices>
+	void _ReplayAt(uint8_t Index, std::index_sequence<Indices...>) const {
+		(void)((Indices == Index && _IDModule_t<SubModules>::ReplayOnResume && Start(Indices, Continuation{})), ...);
+	}
+#ifdef GBEC_STATIC_DISPATCH
+	std::tuple<_IDModule_t<SubModules>* const...> const Pointers;
+	template<typename TFunction, size_t... Indices>
+	bool _Visit(uint8_t Index, TFunction&& Function, std::index_sequence<Indices...>) const {
+		bool Result = false;
+		(void)((Index == Indices && (Result = Function(std::get<Indices>(Pointers)), true)) || ...);
+		return Result;
+	}
+#else
+	Module* const Pointers[sizeof...(SubModules)];  // SAM编译器不能自动推断数组长度
+#endif
+};
+
+// 模块的InfoStruct必须可以在编译期构造，由_InfoBlob存入闪存
+#define InfoImplement \
+	static UID const ID; \
+	template<typename> \
+	friend struct _InfoBlob
+struct OneTimeFC {
+protected:
+	Continuation FinishCallback;
+	//防止Skip重复调用或未运行就Skip，FinishCallback必须调完即弃。
+	void FcAndDiscard() {
+		Continuation const FC = FinishCallback;
+		FinishCallback = {};
+		FC();
+	}
+};
+template<typename... SubModules>
+struct RandomSequential : Module, IRandom, OneTimeFC {
+protected:
+#pragma pack(push, 1)
+	struct InfoStruct {
+		uint8_t const NumFields = 2;
+		PodField<UID> const ID{ UID::Field_ID, _ModuleID<RandomSequential>::ID };
+		UID const Field2Name = UID::Field_Modules;
+		UID const Field2Type = UID::Type_Array;
+		uint8_t const NumModules{ sizeof...(SubModules) };
+		UID const ModuleType = UID::Type_Pointer;
+		UID const* const ModuleValues[sizeof...(SubModules)] = { &_ModuleID<_IDModule_t<SubModules>>::ID... };
+	};
+#pragma pack(pop)
+	_Children<SubModules...> const Children{ Module::Container };
+	// 打乱后的执行顺序，元素为子模块序号
+	uint8_t Order[sizeof...(SubModules)];
+	// Order中当前执行的位置，等于子模块数表示未在运行
+	uint8_t Current = sizeof...(SubModules);
+
+public:
+	template<uint16_t... Repeats>
+	struct WithRepeat : Module, IRandom, OneTimeFC {
+		using Dependencies = detail::type_list<SubModules...>;
+
+	protected:
+#pragma pack(push, 1)
+		struct InfoStruct {
+			uint8_t const NumFields = 2;
+			PodField<UID> const ID{ UID::Field_ID, _ModuleID<WithRepeat>::ID };
+			UID const Field2Name = UID::Field_Modules;
+			UID const Field2Type = UID::Type_Table;
+			uint8_t const NumModules{ sizeof...(SubModules) };
+			uint8_t const NumColumns = 2;
+			UID const Column1Name = UID::Column_Module;
+			UID const Column1Type = UID::Type_Pointer;
+			UID const* const Column1Values[sizeof...(SubModules)] = { &_ModuleID<_IDModule_t<SubModules>>::ID... };
+			UID const Column2Name = UID::Column_Repeats;
+			UID const Column2Type = UID::Type_UInt16;
+			uint16_t const Column2Values[sizeof...(SubModules)];
+			constexpr InfoStruct()
+				: Column2Values{ Repeats... } {
+			}
+		};
+#pragma pack(pop)
+		static constexpr uint16_t NumSteps = _Sum<Repeats...>::value;
+		static constexpr uint16_t RepeatCounts[sizeof...(SubModules)] = { Repeats... };
+		_Children<SubModules...> const Children{ Module::Container };
+		/*不存储整张顺序表，而是每步按各子模块的剩余次数加权、不放回地抽取下一个子模块，等价于对顺序表均匀洗牌后依次取出，内存不随总步数增长。
+		抽签发生器与进程的Rng同为SessionRandom，用Below按固定算法抽取，在每轮开始时以Seed重置，因此两次Randomize之间每轮的顺序都相同，与预先洗牌的顺序表行为一致。
+		*/
+		uint32_t Seed;
+		SessionRandom Draw;
+		// 各子模块本轮尚未抽出的次数
+		uint16_t Remaining[sizeof...(SubModules)];
+		// 本轮当前的步序，等于NumSteps表示未在运行
+		uint16_t Current = NumSteps;
+		// 当前步执行的子模块序号
+		uint8_t CurrentChild;
+		void _Rewind() {
+			Draw.seed(Seed);
+			std::copy(std::begin(RepeatCounts), std::end(RepeatCounts), std::begin(Remaining));
+		}
+		// 抽取第Current步的子模块。此前已抽出Current步，剩余NumSteps-Current步。
+		uint8_t _Draw() {
+			uint16_t Pick = Draw.Below(NumSteps - Current);
+			uint8_t Child = 0;
+			while (Pick >= Remaining[Child])
+				Pick -= Remaining[Child++];
+			--Remaining[Child];
+			return Child;
+		}
+
+	public:
+		void Randomize() override {
+			Seed = Module::Container.Rng();
+		}
+		WithRepeat(Process& Container)
+			: Module(Container) {
+			Randomize();
+		}
+		void Abort() override {
+			if (Current < NumSteps) {
+				Children.Abort(CurrentChild);
+				FinishCallback = {};
+			}
+		}
+		void Skip() {
+			if (Current < NumSteps) {
+				Children.Abort(CurrentChild);
+				if (FinishCallback)  //被Restart启动的运行状态，FinishCallback可能为空
+					FcAndDiscard();
+			}
+		}
+		void Resume(uint8_t) override {
+			while (++Current < NumSteps)
+				if (Children.Start(CurrentChild = _Draw(), Continuation{ this }))
+					return;
+			FcAndDiscard();
+		}
+		void Restart() override {
+			Abort();
+			_Rewind();
+			for (Current = 0; Current < NumSteps; ++Current)
+				if (Children.Start(CurrentChild = _Draw(), Continuation{ this }))
+					return;
+		}
+		bool Start(Continuation FC) override {
+			Abort();
+			_Rewind();
+			for (Current = 0; Current < NumSteps; ++Current)
+				if (Children.Start(CurrentChild = _Draw(), Continuation{ this })) {
+					FinishCallback = FC;
+					return true;
+				}
+			return false;
+		}
+		void SaveCheckpoint(Checkpoint& C) const override {
+			C.Put(Current);
+			if (Current < NumSteps) {
+				C.Put(Seed);
+				C.Put(CurrentChild);
+				for (uint16_t R : Remaining)
+					C.Put(R);
+				Children.SaveCheckpoint(CurrentChild, C);
+			}
+		}
+		/*以Seed重放本轮已抽取的步骤，使抽签发生器回到断点时的状态，期间重新执行其中ReplayOnResume的子模块。
+		若本轮中途重新随机化过，Seed已不是本轮的种子，重放得到的状态与断点不符；此时以断点记录的当前子模块和剩余次数为准，此后的顺序可能与原本不同，但各子模块的总次数不变，已完成的步骤不会重做。
+		*/
+		bool StartFrom(Checkpoint& C, Continuation FC) override {
+			Abort();
+			uint16_t const Step = C.Get<uint16_t>();
+			if (Step >= NumSteps)
+				return Start(FC);
+			uint32_t const SavedSeed = C.Get<uint32_t>();
+			uint8_t const SavedChild = C.Get<uint8_t>();
+			uint16_t SavedRemaining[sizeof...(SubModules)];
+			for (uint16_t& R : SavedRemaining)
+				R = C.Get<uint16_t>();
+			// 断点与会话不符时从头开始
+			if (SavedChild >= Children.Count || std::accumulate(std::begin(SavedRemaining), std::end(SavedRemaining), uint32_t(Step) + 1) != NumSteps)
+				return Start(FC);
+			Seed = SavedSeed;
+			_Rewind();
+			for (Current = 0; Current < Step; ++Current)
+				Children.ReplayAt(_Draw());
+			_Draw();
+			std::copy(std::begin(SavedRemaining), std::end(SavedRemaining), std::begin(Remaining));
+			bool Waiting = Children.StartFrom(CurrentChild = SavedChild, C, Continuation{ this });
+			while (!Waiting && ++Current < NumSteps)
+				Waiting = Children.Start(CurrentChild = _Draw(), Continuation{ this });
+			if (Waiting)
+				FinishCallback = FC;
+			return Waiting;
+		}
+		static constexpr uint16_t NumTrials = _Sum<_IDModule_t<SubModules>::NumTrials * Repeats...>::value;
+		static constexpr uint8_t MaxTimers = _Max<_IDModule_t<SubModules>::MaxTimers...>::value;
+		static constexpr size_t CheckpointBytes = sizeof(uint16_t) + sizeof(uint32_t) + sizeof(uint8_t) + sizeof(uint16_t) * sizeof...(SubModules) + _Max<_IDModule_t<SubModules>::CheckpointBytes...>::value;
+		InfoImplement;
+	};
+	// Fisher-Yates洗牌。不用std::shuffle，以免顺序随标准库实现而异
+	void Randomize() override {
+		for (uint8_t I = sizeof...(SubModules); I > 1; --I)
+			std::swap(Order[I - 1], Order[Module::Container.Rng.Below(I)]);
+	}
+	RandomSequential(Process& Container)
+		: Module(Container) {
+		std::iota(std::begin(Order), std::end(Order), 0);
+		Randomize();
+	}
+	void Abort() override {
+		if (Current < Children.Count) {
+			Children.Abort(Order[Current]);
+			FinishCallback = {};
+		}
+	}
+	void Resume(uint8_t) override {
+		while (++Current < Children.Count)
+			if (Children.Start(Order[Current], Continuation{ this }))
+				return;
+		FcAndDiscard();
+	}
+	void Restart() override {
+		Abort();
+		for (Current = 0; Current < Children.Count; ++Current)
+			if (Children.Start(Order[Current], Continuation{ this }))
+				return;
+	}
+	bool Start(Continuation FC) override {
+		Abort();
+		for (Current = 0; Current < Children.Count; ++Current)
+			if (Children.Start(Order[Current], Continuation{ this })) {
+				FinishCallback = FC;
+				return true;
+			}
+		return false;
+	}
+	// 执行中可能重新随机化，因此连同当前顺序一起记录
+	void SaveCheckpoint(Checkpoint& C) const override {
+		C.Put(Current);
+		if (Current < Children.Count) {
+			for (uint8_t O : Order)
+				C.Put(O);
+			Children.SaveCheckpoint(Order[Current], C);
+		}
+	}
+	bool StartFrom(Checkpoint& C, Continuation FC) override {
+		Abort();
+		uint8_t const Position = C.Get<uint8_t>();
+		if (Position >= Children.Count)
+			return Start(FC);
+		uint8_t SavedOrder[sizeof...(SubModules)];
+		for (uint8_t& O : SavedOrder)
+			if ((O = C.Get<uint8_t>()) >= Children.Count)
+				return Start(FC);
+		std::copy(std::begin(SavedOrder), std::end(SavedOrder), std::begin(Order));
+		for (Current = 0; Current < Position; ++Current)
+			Children.ReplayAt(Order[Current]);
+		bool Waiting = Children.StartFrom(Order[Current], C, Continuation{ this });
+		while (!Waiting && ++Current < Children.Count)
+			Waiting = Children.Start(Order[Current], Continuation{ this });
+		if (Waiting)
+			FinishCallback = FC;
+		return Waiting;
+	}
+	static constexpr uint16_t NumTrials = _Sum<_IDModule_t<SubModules>::NumTrials...>::value;
+	static constexpr uint8_t MaxTimers = _Max<_IDModule_t<SubModules>::MaxTimers...>::value;
+	static constexpr size_t CheckpointBytes = sizeof(uint8_t) + sizeof...(SubModules) + _Max<_IDModule_t<SubModules>::CheckpointBytes...>::value;
+	InfoImplement;
+};
+template<typename... SubModules>
+UID const RandomSequential<SubModules...>::ID = UID::Module_RandomSequential;
+template<typename... SubModules>
+template<uint16_t... Repeats>
+UID const RandomSequential<SubModules...>::WithRepeat<Repeats...>::ID = UID::Module_RandomSequential;
+// 表示一个固定整数
+template<DurationRep Value>
+struct ConstantInteger : IInformative {
+protected:
+#pragma pack(push, 1)
+	struct InfoStruct {
+		uint8_t const NumFields = 2;
+		PodField<UID> const ID{ UID::Field_ID, UID::Module_ConstantInteger };
+		PodField<DurationRep> const ValueField{ UID::Field_Value, Value };
+	};
+#pragma pack(pop)
+public:
+	static constexpr uint16_t NumTrials = Value;
+	constexpr DurationRep Current() const {
+		return Value;
+	}
+	InfoImplement;
+};
+template<DurationRep Value>
+UID const ConstantInteger<Value>::ID = UID::Module_ConstantInteger;
+// 表示一个随机整数。该步骤维护一个随机变量，只有使用Randomize步骤才能改变这个变量，否则一直保持相同的值。如果有多个随机范围相同的随机变量需要独立控制随机性，可以指定不同的ID，否则视为同一个随机变量。
+template<DurationRep Min, DurationRep Max, UID CustomID = UID::Module_RandomInteger>
+struct RandomInteger : IInformative, IRandom {
+protected:
+#pragma pack(push, 1)
+	struct InfoStruct {
+		uint8_t const NumFields = 2;
+		PodField<UID> const ID{ UID::Field_ID, CustomID };
+		UID const Field2Name = UID::Field_Range;
+		UID const Field2Type = UID::Type_Array;
+		uint8_t const NumElements = 2;
+		UID const ElementType = _TypeID<DurationRep>::value;
+		DurationRep const MinValue = Min;
+		DurationRep const MaxValue = Max;
+	};
+#pragma pack(pop)
+	SessionRandom& Rng;
+	DurationRep _Current;
+
+public:
+	RandomInteger(Process& Container)
+		: Rng(Container.Rng) {
+		Randomize();
+	}
+	void Randomize() {
+		constexpr double DoubleMin = Min;
+		_Current = static_cast<DurationRep>(pow(static_cast<double>(Max) / DoubleMin, static_cast<double>(Rng()) / SessionRandom::max()) * DoubleMin);
+	}
+	static constexpr uint16_t NumTrials = 0;
+	DurationRep Current() const {
+		return _Current;
+	}
+	InfoImplement;
+};
+template<DurationRep Min, DurationRep Max, UID CustomID>
+UID const RandomInteger<Min, Max, CustomID>::ID = CustomID;
+using Infinite = void;
+// 无限重复模块，也可以额外指定UntilTimes重复次数。不能指定重复时间，请组合使用 Async Delay ModuleAbort 等模块实现。
+template<typename Content, typename Times = Infinite>
+struct Repeat : Module {
+protected:
+	uint16_t TimesLeft;
+	Times const* const T;
+#pragma pack(push, 1)
+	struct InfoStruct {
+		uint8_t const NumFields = 3;
+		PodField<UID> const ID{ UID::Field_ID, _ModuleID<Repeat>::ID };
+		PodField<UID const*> const ContentField{ UID::Field_Content, &_ModuleID<_IDModule_t<Content>>::ID };
+		PodField<UID const*> const TimesField{ UID::Field_Times, &_ModuleID<Times>::ID };
+	};
+#pragma pack(pop)
+	_IDModule_t<Content>* const ContentPtr = Module::Container.LoadModule<Content>();
+	// 直接Restart而未Start时为空，执行完毕后无事可做
+	Continuation FinishCallback;
+
+public:
+	Repeat(Process& Container)
+		: Module(Container), T{ Module::Container.LoadModule<Times>() } {
+	}
+	void Resume(uint8_t) override {
+		while (--TimesLeft)
+			if (_StartChild(ContentPtr, Continuation{ this }))
+				return;
+		FinishCallback();
+	}
+	void Restart() override {
+		Abort();
+		for (TimesLeft = T->Current(); TimesLeft; --TimesLeft)
+			if (_StartChild(ContentPtr, Continuation{ this }))
+				return;
+	}
+	bool Start(Continuation FC) override {
+		Abort();
+		for (TimesLeft = T->Current(); TimesLeft; --TimesLeft)
+			if (_StartChild(ContentPtr, Continuation{ this })) {
+				FinishCallback = FC;
+				return true;
+			}
+		return false;
+	}
+	void SaveCheckpoint(Checkpoint& C) const override {
+		C.Put(TimesLeft);
+		if (TimesLeft)
+			ContentPtr->SaveCheckpoint(C);
+	}
+	bool StartFrom(Checkpoint& C, Continuation FC) override {
+		Abort();
+		TimesLeft = C.Get<uint16_t>();
+		if (!TimesLeft)
+			return Start(FC);
+		bool Waiting = ContentPtr->StartFrom(C, Continuation{ this });
+		while (!Waiting && --TimesLeft)
+			Waiting = _StartChild(ContentPtr, Continuation{ this });
+		if (Waiting)
+			FinishCallback = FC;
+		return Waiting;
+	}
+	static constexpr uint16_t NumTrials = _IDModule_t<Content>::NumTrials * Times::NumTrials;
+	static constexpr uint8_t MaxTimers = _IDModule_t<Content>::MaxTimers;
+	static constexpr size_t CheckpointBytes = sizeof(uint16_t) + _IDModule_t<Content>::CheckpointBytes;
+	InfoImplement;
+};
+template<typename Content, typename Times>
+UID const Repeat<Content, Times>::ID = UID::Module_Repeat;
+template<typename Content>
+struct Repeat<Content, Infinite> : Module {
+protected:
+#pragma pack(push, 1)
+	struct InfoStruct {
+		uint8_t const NumFields = 2;
+		PodField<UID> const ID{ UID::Field_ID, _ModuleID<Repeat>::ID };
+		PodField<UID const*> const ContentField{ UID::Field_Content, &_ModuleID<_IDModule_t<Content>>::ID };
+	};
+#pragma pack(pop)
+	_IDModule_t<Content>* const ContentPtr = Module::Container.LoadModule<Content>();
+public:
+	using Module::Module;
+	void Abort() override {
+		_AbortChild(ContentPtr);
+	}
+	void Resume(uint8_t) override {
+		for (;;)
+			if (_StartChild(ContentPtr, Continuation{ this }))
+				return;
+	}
+	void Restart() override {
+		_AbortChild(ContentPtr);
+		Resume(0);
+	}
+	bool Start(Continuation FC) override {
+		Abort();
+		Resume(0);
+		return true;
+	}
+	void SaveCheckpoint(Checkpoint& C) const override {
+		ContentPtr->SaveCheckpoint(C);
+	}
+	bool StartFrom(Checkpoint& C, Continuation FC) override {
+		Abort();
+		if (!ContentPtr->StartFrom(C, Continuation{ this }))
+			Resume(0);
+		return true;
+	}
+	static constexpr uint16_t NumTrials = _IDModule_t<Content>::NumTrials;
+	static constexpr uint8_t MaxTimers = _IDModule_t<Content>::MaxTimers;
+	static constexpr size_t CheckpointBytes = _IDModule_t<Content>::CheckpointBytes;
+	InfoImplement;
+};
+template<typename Content>
+UID const Repeat<Content, Infinite>::ID = UID::Module_Repeat;
+template<typename... SubModules>
+struct _Sequential : Module {
+protected:
+	_Children<SubModules...> const Children{ Module::Container };
+	// 当前执行的子模块序号，等于子模块数表示未在运行
+	uint8_t Current = sizeof...(SubModules);
+
+	// 直接Restart而未Start时为空，也能执行完整个模块
+	Continuation FinishCallback;
+#pragma pack(push, 1)
+	struct InfoStruct {
+		uint8_t const NumFields = 2;
+		PodField<UID> const ID{ UID::Field_ID, _ModuleID<_Sequential>::ID };
+		UID const Field2Name = UID::Field_Modules;
+		UID const Field2Type = UID::Type_Array;
+		uint8_t const NumModules{ sizeof...(SubModules) };
+		UID const ModuleType = UID::Type_Pointer;
+		UID const* const ModuleValues[sizeof...(SubModules)] = { &_ModuleID<_IDModule_t<SubModules>>::ID... };
+	};
+#pragma pack(pop)
+public:
+	_Sequential(Process& Container)
+		: Module(Container) {
+	}
+	void Abort() override {
+		if (Current < Children.Count)
+			Children.Abort(Current);
+	}
+	void Resume(uint8_t) override {
+		while (++Current < Children.Count)
+			if (Children.Start(Current, Continuation{ this }))
+				return;
+		FinishCallback();
+	}
+	void Restart() override {
+		Abort();
+		for (Current = 0; Current < Children.Count; ++Current)
+			if (Children.Start(Current, Continuation{ this }))
+				return;
+	}
+	bool Start(Continuation FC) override {
+		Abort();
+		for (Current = 0; Current < Children.Count; ++Current) {
+			if (Children.Start(Current, Continuation{ this })) {
+				FinishCallback = FC;
+				return true;
+			}
+		}
+		return false;
+	}
+	void SaveCheckpoint(Checkpoint& C) const override {
+		C.Put(Current);
+		if (Current < Children.Count)
+			Children.SaveCheckpoint(Current, C);
+	}
+	// 跳过断点之前的子模块，只重新执行其中ReplayOnResume的
+	bool StartFrom(Checkpoint& C, Continuation FC) override {
+		Abort();
+		Current = C.Get<uint8_t>();
+		if (Current >= Children.Count)
+			return Start(FC);
+		Children.Replay(Current);
+		bool Waiting = Children.StartFrom(Current, C, Continuation{ this });
+		while (!Waiting && ++Current < Children.Count)
+			Waiting = Children.Start(Current, Continuation{ this });
+		if (Waiting)
+			FinishCallback = FC;
+		return Waiting;
+	}
+	static constexpr uint16_t NumTrials = _Sum<_IDModule_t<SubModules>::NumTrials...>::value;
+	static constexpr uint8_t MaxTimers = _Max<_IDModule_t<SubModules>::MaxTimers...>::value;
+	static constexpr size_t CheckpointBytes = sizeof(uint8_t) + _Max<_IDModule_t<SubModules>::CheckpointBytes...>::value;
+	// 子模块都可重放时，整体也是瞬时的，可以重放
+	static constexpr bool ReplayOnResume = (_IDModule_t<SubModules>::ReplayOnResume && ...);
+	InfoImplement;
+};
+template<>
+struct _Sequential<> : Module {
+protected:
+#pragma pack(push, 1)
+	struct InfoStruct {
+		uint8_t const NumFields = 0;
+	};
+#pragma pack(pop)
+public:
+	_Sequential(Process& Container)
+		: Module(Container) {
+	}
+	static constexpr uint16_t NumTrials = 0;
+	InfoImplement;
+};
+template<typename... SubModules>
+UID const _Sequential<SubModules...>::ID = UID::Module_Sequential;
+
+namespace detail {
+	template<typename... Args>
+	struct flatten_pack;
+
+	template<typename T>
+	struct flatten_one {
+		using type = type_list<T>;
+	};
+
+	template<typename... Inner>
+	struct flatten_one<_Sequential<Inner...>> {
+		using type = typename flatten_pack<Inner...>::type;
+	};
+
+	template<>
+	struct flatten_pack<> {
+		using type = type_list<>;
+	};
+
+	template<typename Head, typename... Tail>
+	struct flatten_pack<Head, Tail...> {
+		using type = typename concat<
+			typename flatten_one<Head>::type,
+			typename flatten_pack<Tail...>::type>::type;
+	};
+
+	template<typename List>
+	struct list_to_seq;
+	template<typename... Ts>
+	struct list_to_seq<type_list<Ts...>> {
+		using type = _Sequential<Ts...>;
+	};
+}
+// 依次执行模块。嵌套的Sequential会被展开。
+template<typename... Args>
+using Sequential = typename detail::list_to_seq<
+	typename detail::flatten_pack<Args...>::type>::type;
+
+// 硬件计时器在分配时才确定，软件计时器就嵌在模块中
+template<typename TTimer>
+struct _TimerSlot {
+	typename _ActiveList<TTimer>::Node Registration;
+};
+template<>
+struct _TimerSlot<SoftTimer> {
+	SoftTimer Own;
+	_ActiveList<SoftTimer>::Node Registration{ &Own };
+};
+template<typename TTimer>
+struct _TimedModule : Module {
+	using Module::Module;
+	// 只统计硬件计时器
+	static constexpr uint8_t MaxTimers = std::is_same<TTimer, Timers_one_for_all::TimerClass>::value;
+	void Abort() override {
+		if (Timer) {
+			Timer->Stop();
+			UnregisterTimer();
+		}
+#ifdef GBEC_DEFER_TIMER_CONTINUATIONS
+		// 可能已到期而续延尚在排队
+		RunQueue::Cancel(FinishCallback);
+#endif
+	}
+
+protected:
+	TTimer* Timer = nullptr;
+	// 在Process::ActiveTimers或ActiveSoftTimers中的登记
+	_TimerSlot<TTimer> TimerSlot;
+	// 直接Restart而未Start时为空，计时结束后只释放计时器
+	Continuation FinishCallback;
+	// 不检查当前Timer是否有效
+	void UnregisterTimer() {
+		Module::Container.UnregisterTimer(TimerSlot.Registration);
+		Timer = nullptr;
+	}
+	void AllocateTimer() {
+		Timer = Module::Container.AllocateTimer(TimerSlot.Registration);
+	}
+	// 交给计时器库的结束回调：释放计时器，然后调用FinishCallback。只捕获一个指针，构造一次后不再改写。
+	struct _UnregisterTimer {
+		_TimedModule* const ContentModule;
+		void operator()() const {
+			GBEC_TIMER_ISR_SCOPE();
+			GBEC_ALLOCATION_SCOPE(ContentModule->Container, ContentModule);
+			EventClock::Unpinned const Unpinned;
+			ContentModule->UnregisterTimer();
+#ifdef GBEC_DEFER_TIMER_CONTINUATIONS
+			if (ContentModule->FinishCallback)
+				RunQueue::Post(ContentModule->FinishCallback, MaxTimers ? RunQueue::High : RunQueue::Normal);
+#else
+			ContentModule->FinishCallback();
+#endif
+		}
+	};
+};
+template<typename TTimer>
+struct _Delay : _TimedModule<TTimer> {
+	using MyTimed = _TimedModule<TTimer>;
+	using MyTimed::_TimedModule;
+	void Restart() override {
+		if (!MyTimed::Timer)
+			MyTimed::AllocateTimer();
+	}
+	bool Start(Continuation FC) override {
+		MyTimed::FinishCallback = FC;
+		Restart();
+		return true;
+	}
+	static constexpr size_t HeapBytes = detail::function_heap_bytes(sizeof(typename MyTimed::_UnregisterTimer));
+
+protected:
+	std::move_only_function<void()> TimerCallback{ typename MyTimed::_UnregisterTimer{ this } };
+};
+template<typename Unit = Infinite, typename Value = Infinite>
+struct Delay : _Delay<_TimerFor<Unit>> {
+protected:
+#pragma pack(push, 1)
+	struct InfoStruct {
+		uint8_t const NumFields = 3;
+		PodField<UID> const ID{ UID::Field_ID, _ModuleID<Delay>::ID };
+		PodField<UID> const UnitField{ UID::Field_Unit, _TypeID<Unit>::value };
+		PodField<UID const*> const Duration{ UID::Field_Duration, &_ModuleID<Value>::ID };
+	};
+#pragma pack(pop)
+	Value const* const DurationPtr = Module::Container.LoadModule<Value>();
+	using MyBase = _Delay<_TimerFor<Unit>>;
+
+public:
+	using MyBase::_Delay;
+	void Restart() override {
+		MyBase::Restart();  // 不能用_TimedModule，调不到_Delay版本
+		MyBase::Timer->DoAfter(Unit{ DurationPtr->Current() }, MyBase::TimerCallback);
+	}
+	// 软件计时的等待在断点中记录剩余毫秒数；微秒级的硬件计时太短，恢复时从头等待
+	static constexpr size_t CheckpointBytes = std::is_same<_TimerFor<Unit>, SoftTimer>::value ? sizeof(uint32_t) : 0;
+	void SaveCheckpoint(Checkpoint& C) const override {
+		if constexpr (CheckpointBytes > 0)
+			C.Put(static_cast<uint32_t>(MyBase::Timer ? MyBase::Timer->Remaining() / 1000 : 0));
+	}
+	bool StartFrom(Checkpoint& C, Continuation FC) override {
+		if constexpr (CheckpointBytes > 0) {
+			MyBase::FinishCallback = FC;
+			MyBase::Restart();
+			MyBase::Timer->DoAfter(std::chrono::milliseconds{ C.Get<uint32_t>() }, MyBase::TimerCallback);
+			return true;
+		} else
+			return MyBase::Start(FC);
+	}
+	InfoImplement;
+};
+template<typename Unit, typename Value>
+UID const Delay<Unit, Value>::ID = UID::Module_Delay;
+template<>
+struct Delay<Infinite, Infinite> : Module {
+
+	using Module::Module;
+	bool Start(Continuation FC) override {
+		FinishCallback = FC;
+		return true;
+	}
+	void Skip() {
+		FinishCallback();
+	}
+	InfoImplement;
+protected:
+#pragma pack(push, 1)
+	struct InfoStruct {
+		uint8_t const NumFields = 2;
+		PodField<UID> const ID{ UID::Field_ID, _ModuleID<Delay>::ID };
+		UID const Field2Name = UID::Field_Duration;
+		UID const Field2Type = UID::Type_Infinite;
+	};
+#pragma pack(pop)
+	Continuation FinishCallback;
+};
+template<typename Content, typename Period, typename TTimer>
+struct _RepeatEvery : _TimedModule<TTimer> {
+	using MyTimed = _TimedModule<TTimer>;
+	using MyTimed::_TimedModule;
+	// 每个周期启动的Content可能在后台延续到下个周期
+	using BackgroundModules = detail::type_list<Content>;
+	void Abort() override {
+		_AbortChild(ContentPtr);
+		MyTimed::Abort();
+	}
+	void Restart() override {
+		if (MyTimed::Timer)
+			_AbortChild(ContentPtr);
+		else
+			MyTimed::AllocateTimer();
+	}
+	bool Start(Continuation FC) override {
+		// 默认的无限重复，不需要FinishCallback。
+		Restart();
+		return true;
+	}
+	static constexpr size_t HeapBytes = detail::function_heap_bytes(sizeof(Module::_EmptyStart<_IDModule_t<Content>>));
+
+protected:
+	_IDModule_t<Content>* const ContentPtr = Module::Container.LoadModule<Content>();
+	std::move_only_function<void()> RepeatCallback{ Module::_EmptyStart<_IDModule_t<Content>>{ ContentPtr } };
+	Period const* const PeriodPtr = Module::Container.LoadModule<Period>();
+};
+/*
+每隔指定周期，执行一次内容模块。这个周期就是最终的绝对的周期长度，内容模块异步执行，不占用周期时间。第一次执行也需要等待周期时长之后。
+此模块为固定周期的高频循环优化，比组合使用Repeat和Delay效率更高更方便。但是，一旦此模块开始，周期长度即固定。如果采用随机周期值，那个周期值将在模块开始时确定，后续再改变随机变量值也不会改变此模块的周期，除非重启。因此，不能使用此模块实现每个周期时长随机。要实现此效果，请组合使用Repeat和Delay模块。
+*/
+template<typename Content, typename Unit, typename Period, typename Times = Infinite>
+struct RepeatEvery : _RepeatEvery<Content, Period, _TimerFor<Unit>> {
+protected:
+	std::move_only_function<void()> TimerCallback{ typename MyBase::_UnregisterTimer{ this } };
+	Times const* const TimesPtr = Module::Container.LoadModule<Times>();
+#pragma pack(push, 1)
+	struct InfoStruct {
+		uint8_t const NumFields = 5;
+		PodField<UID> const ID{ UID::Field_ID, _ModuleID<RepeatEvery>::ID };
+		PodField<UID const*> const ContentField{ UID::Field_Content, &_ModuleID<Content>::ID };
+		PodField<UID> const UnitField{ UID::Field_Unit, _TypeID<Unit>::value };
+		PodField<UID const*> const PeriodField{ UID::Field_Period, &_ModuleID<Period>::ID };
+		PodField<UID const*> const TimesField{ UID::Field_Times, &_ModuleID<Times>::ID };
+	};
+#pragma pack(pop)
+	using MyBase = _RepeatEvery<Content, Period, _TimerFor<Unit>>;
+
+public:
+	using MyBase::_RepeatEvery;
+	static constexpr size_t HeapBytes = MyBase::HeapBytes + detail::function_heap_bytes(sizeof(typename MyBase::_UnregisterTimer));
+	void Restart() override {
+		MyBase::Restart();
+		MyBase::Timer->RepeatEvery(Unit{ MyBase::PeriodPtr->Current() }, MyBase::RepeatCallback, TimesPtr->Current(), TimerCallback);
+	}
+	bool Start(Continuation FC) override {
+		if (!TimesPtr->Current())
+			return false;
+		MyBase::FinishCallback = FC;
+		Restart();
+		return true;
+	}
+	static constexpr uint16_t NumTrials = _IDModule_t<Content>::NumTrials * Times::NumTrials;
+	InfoImplement;
+};
+template<typename Content, typename Unit, typename Period, typename Times>
+UID const RepeatEvery<Content, Unit, Period, Times>::ID = UID::Module_RepeatEvery;
+template<typename Content, typename Unit, typename Period>
+struct RepeatEvery<Content, Unit, Period, Infinite> : _RepeatEvery<Content, Period, _TimerFor<Unit>> {
+protected:
+#pragma pack(push, 1)
+	struct InfoStruct {
+		uint8_t const NumFields = 5;
+		PodField<UID> const ID{ UID::Field_ID, _ModuleID<RepeatEvery>::ID };
+		PodField<UID const*> const ContentField{ UID::Field_Content, &_ModuleID<Content>::ID };
+		PodField<UID> const UnitField{ UID::Field_Unit, _TypeID<Unit>::value };
+		PodField<UID const*> const PeriodField{ UID::Field_Period, &_ModuleID<Period>::ID };
+		UID const TimesFieldName = UID::Field_Times;
+		UID const TimesFieldType = UID::Type_Infinite;
+	};
+#pragma pack(pop)
+	using MyBase = _RepeatEvery<Content, Period, _TimerFor<Unit>>;
+
+public:
+	using MyBase::_RepeatEvery;
+	void Restart() override {
+		MyBase::Restart();
+		MyBase::Timer->RepeatEvery(Unit{ MyBase::PeriodPtr->Current() }, MyBase::RepeatCallback);
+	}
+	InfoImplement;
+};
+template<typename Content, typename Unit, typename Period>
+UID const RepeatEvery<Content, Unit, Period, Infinite>::ID = UID::Module_RepeatEvery;
+template<typename ContentA, typename ContentB, typename PeriodA, typename PeriodB, typename TTimer>
+struct _DoubleRepeat : _TimedModule<TTimer> {
+	using MyTimed = _TimedModule<TTimer>;
+	using MyTimed::_TimedModule;
+	using BackgroundModules = detail::type_list<ContentA, ContentB>;
+	void Abort() override {
+		_AbortChild(ContentAPtr);
+		_AbortChild(ContentBPtr);
+		MyTimed::Abort();
+	}
+	void Restart() override {
+		if (MyTimed::Timer) {
+			_AbortChild(ContentAPtr);
+			_AbortChild(ContentBPtr);
+		}
+		else
+			MyTimed::AllocateTimer();
+	}
+	bool Start(Continuation FC) override {
+		// 默认的无限重复，不需要FinishCallback。
+		Restart();
+		return true;
+	}
+	static constexpr size_t HeapBytes = detail::function_heap_bytes(sizeof(Module::_EmptyStart<_IDModule_t<ContentA>>)) + detail::function_heap_bytes(sizeof(Module::_EmptyStart<_IDModule_t<ContentB>>));
+
+protected:
+	_IDModule_t<ContentA>* const ContentAPtr = Module::Container.LoadModule<ContentA>();
+	_IDModule_t<ContentB>* const ContentBPtr = Module::Container.LoadModule<ContentB>();
+	std::move_only_function<void()> RepeatCallbackA{ Module::_EmptyStart<_IDModule_t<ContentA>>{ ContentAPtr } };
+	std::move_only_function<void()> RepeatCallbackB{ Module::_EmptyStart<_IDModule_t<ContentB>>{ ContentBPtr } };
+	PeriodA const* const PeriodAPtr = Module::Container.LoadModule<PeriodA>();
+	PeriodB const* const PeriodBPtr = Module::Container.LoadModule<PeriodB>();
+};
+/*
+等待时间A后，执行一次模块A；再等待时间B后，执行一次模块B，然后循环。周期总时长就是两个时间之和，不等待模块本身的执行时间。
+此模块为固定周期的高频循环优化，比组合使用Repeat和Delay效率更高更方便。但是，一旦此模块开始，周期长度即固定。如果采用随机周期值，那个周期值将在模块开始时确定，后续再改变随机变量值也不会改变此模块的周期，除非重启。因此，不能使用此模块实现每个周期时长随机。要实现此效果，请组合使用Repeat和Delay模块。重复次数为半周期数，即ContentA和ContentB共计执行Times次。
+*/
+template<typename ContentA, typename ContentB, typename Unit, typename PeriodA, typename PeriodB, typename Times = Infinite>
+struct DoubleRepeat : _DoubleRepeat<ContentA, ContentB, PeriodA, PeriodB, _TimerFor<Unit>> {
+protected:
+	std::move_only_function<void()> TimerCallback{ typename MyBase::_UnregisterTimer{ this } };
+#pragma pack(push, 1)
+	struct InfoStruct {
+		uint8_t const NumFields = 7;
+		PodField<UID> const ID{ UID::Field_ID, _ModuleID<DoubleRepeat>::ID };
+		PodField<UID const*> const ContentAField{ UID::Field_ContentA, &_ModuleID<ContentA>::ID };
+		PodField<UID const*> const ContentBField{ UID::Field_ContentB, &_ModuleID<ContentB>::ID };
+		PodField<UID> const UnitField{ UID::Field_Unit, _TypeID<Unit>::value };
+		PodField<UID const*> const PeriodAField{ UID::Field_PeriodA, &_ModuleID<PeriodA>::ID };
+		PodField<UID const*> const PeriodBField{ UID::Field_PeriodB, &_ModuleID<PeriodB>::ID };
+		PodField<UID const*> const TimesField{ UID::Field_Times, &_ModuleID<Times>::ID };
+	};
+#pragma pack(pop)
+	Times const* const TimesPtr = Module::Container.LoadModule<Times>();
+	using MyBase = _DoubleRepeat<ContentA, ContentB, PeriodA, PeriodB, _TimerFor<Unit>>;
+
+public:
+	using MyBase::_DoubleRepeat;
+	static constexpr size_t HeapBytes = MyBase::HeapBytes + detail::function_heap_bytes(sizeof(typename MyBase::_UnregisterTimer));
+	void Restart() override {
+		MyBase::Restart();
+		MyBase::Timer->DoubleRepeat(Unit{ MyBase::PeriodAPtr->Current() }, MyBase::RepeatCallbackA, Unit{ MyBase::PeriodBPtr->Current() }, MyBase::RepeatCallbackB, TimesPtr->Current(), TimerCallback);
+	}
+	bool Start(Continuation FC) override {
+		if (!TimesPtr->Current())
+			return false;
+		MyBase::FinishCallback = FC;
+		Restart();
+		return true;
+	}
+	static constexpr uint16_t NumTrials = (Times::NumTrials + 1) / 2 * _IDModule_t<ContentA>::NumTrials + Times::NumTrials / 2 * _IDModule_t<ContentB>::NumTrials;
+	InfoImplement;
+};
+template<typename ContentA, typename ContentB, typename Unit, typename PeriodA, typename PeriodB, typename Times>
+UID const DoubleRepeat<ContentA, ContentB, Unit, PeriodA, PeriodB, Times>::ID = UID::Module_DoubleRepeat;
+template<typename ContentA, typename ContentB, typename Unit, typename PeriodA, typename PeriodB>
+struct DoubleRepeat<ContentA, ContentB, Unit, PeriodA, PeriodB, Infinite> : _DoubleRepeat<ContentA, ContentB, PeriodA, PeriodB, _TimerFor<Unit>> {
+protected:
+#pragma pack(push, 1)
+	struct InfoStruct {
+		uint8_t const NumFields = 7;
+		PodField<UID> const ID{ UID::Field_ID, _ModuleID<DoubleRepeat>::ID };
+		PodField<UID const*> const ContentAField{ UID::Field_ContentA, &_ModuleID<ContentA>::ID };
+		PodField<UID const*> const ContentBField{ UID::Field_ContentB, &_ModuleID<ContentB>::ID };
+		PodField<UID> const UnitField{ UID::Field_Unit, _TypeID<Unit>::value };
+		PodField<UID const*> const PeriodAField{ UID::Field_PeriodA, &_ModuleID<PeriodA>::ID };
+		PodField<UID const*> const PeriodBField{ UID::Field_PeriodB, &_ModuleID<PeriodB>::ID };
+		UID const TimesFieldName = UID::Field_Times;
+		UID const TimesFieldType = UID::Type_Infinite;
+	};
+#pragma pack(pop)
+	using MyBase = _DoubleRepeat<ContentA, ContentB, PeriodA, PeriodB, _TimerFor<Unit>>;
+
+public:
+	using MyBase::_DoubleRepeat;
+	void Restart() override {
+		MyBase::Restart();
+		MyBase::Timer->DoubleRepeat(Unit{ MyBase::PeriodAPtr->Current() }, MyBase::RepeatCallbackA, Unit{ MyBase::PeriodBPtr->Current() }, MyBase::RepeatCallbackB);
+	}
+	InfoImplement;
+};
+template<typename ContentA, typename ContentB, typename Unit, typename PeriodA, typename PeriodB>
+UID const DoubleRepeat<ContentA, ContentB, Unit, PeriodA, PeriodB, Infinite>::ID = UID::Module_DoubleRepeat;
+struct _InstantaneousModule : Module {
+	using Module::Module;
+	bool Start(Continuation FC) override {
+		Restart();
+		return false;
+	}
+};
+template<typename Target>
+struct ModuleAbort : _InstantaneousModule {
+protected:
+	_IDModule_t<Target>* const TargetPtr = Module::Container.LoadModule<Target>();
+#pragma pack(push, 1)
+	struct InfoStruct {
+		uint8_t const NumFields = 2;
+		PodField<UID> const ID{ UID::Field_ID, _ModuleID<ModuleAbort>::ID };
+		PodField<UID const*> const TargetField{ UID::Field_Target, &_ModuleID<Target>::ID };
+	};
+#pragma pack(pop)
+public:
+	using _InstantaneousModule::_InstantaneousModule;
+	void Restart() override {
+		_AbortChild(TargetPtr);
+	}
+	InfoImplement;
+};
+template<typename Target>
+UID const ModuleAbort<Target>::ID = UID::Module_Abort;
+template<typename Target>
+struct ModuleSkip : _InstantaneousModule {
+protected:
+	Target* const TargetPtr = Module::Container.LoadModule<Target>();
+#pragma pack(push, 1)
+	struct InfoStruct {
+		uint8_t const NumFields = 2;
+		PodField<UID> const ID{ UID::Field_ID, _ModuleID<ModuleSkip>::ID };
+		PodField<UID const*> const TargetField{ UID::Field_Target, &_ModuleID<Target>::ID };
+	};
+#pragma pack(pop)
+public:
+	using _InstantaneousModule::_InstantaneousModule;
+	void Restart() override {
+		TargetPtr->Skip();
+	}
+	InfoImplement;
+};
+template<typename Target>
+UID const ModuleSkip<Target>::ID = UID::Module_Skip;
+template<typename Target>
+struct ModuleRestart : _InstantaneousModule {
+	using BackgroundModules = detail::type_list<Target>;
+
+protected:
+	_IDModule_t<Target>* const TargetPtr = Module::Container.LoadModule<Target>();
+#pragma pack(push, 1)
+	struct InfoStruct {
+		uint8_t const NumFields = 2;
+		PodField<UID> const ID{ UID::Field_ID, _ModuleID<ModuleRestart>::ID };
+		PodField<UID const*> const TargetField{ UID::Field_Target, &_ModuleID<Target>::ID };
+	};
+#pragma pack(pop)
+public:
+	using _InstantaneousModule::_InstantaneousModule;
+	void Restart() override {
+		_RestartChild(TargetPtr);
+	}
+	InfoImplement;
+};
+template<typename Target>
+UID const ModuleRestart<Target>::ID = UID::Module_Restart;
+template<typename Target>
+struct ModuleRandomize : _InstantaneousModule {
+protected:
+	IRandom* const TargetPtr = Module::Container.LoadModule<Target>();
+#pragma pack(push, 1)
+	struct InfoStruct {
+		uint8_t const NumFields = 2;
+		PodField<UID> const ID{ UID::Field_ID, _ModuleID<ModuleRandomize>::ID };
+		PodField<UID const*> const TargetField{ UID::Field_Target, &_ModuleID<Target>::ID };
+	};
+#pragma pack(pop)
+public:
+	using _InstantaneousModule::_InstantaneousModule;
+	void Restart() override {
+		TargetPtr->Randomize();
+	}
+	InfoImplement;
+};
+template<typename Target>
+UID const ModuleRandomize<Target>::ID = UID::Module_Randomize;
+template<uint8_t Pin, bool HighOrLow>
+struct DigitalWrite : _InstantaneousModule {
+protected:
+#pragma pack(push, 1)
+	struct InfoStruct {
+		uint8_t const NumFields = 3;
+		PodField<UID> const ID{ UID::Field_ID, _ModuleID<DigitalWrite>::ID };
+		PodField<uint8_t> const PinField{ UID::Field_Pin, Pin };
+		PodField<bool> const HighOrLowField{ UID::Field_HighOrLow, HighOrLow };
+	};
+#pragma pack(pop)
+public:
+	DigitalWrite(Process& Container)
+		: _InstantaneousModule(Container) {
+		Quick_digital_IO_interrupt::PinMode<Pin, OUTPUT>();
+	}
+	void Restart() override {
+		Quick_digital_IO_interrupt::DigitalWrite<Pin, HighOrLow>();
+	}
+	static constexpr bool ReplayOnResume = true;
+	InfoImplement;
+};
+template<uint8_t Pin, bool HighOrLow>
+UID const DigitalWrite<Pin, HighOrLow>::ID = UID::Module_DigitalWrite;
+template<uint8_t Pin>
+struct DigitalToggle : _InstantaneousModule {
+protected:
+#pragma pack(push, 1)
+	struct InfoStruct {
+		uint8_t const NumFields = 2;
+		PodField<UID> const ID{ UID::Field_ID, _ModuleID<DigitalToggle>::ID };
+		PodField<uint8_t> const PinField{ UID::Field_Pin, Pin };
+	};
+#pragma pack(pop)
+public:
+	DigitalToggle(Process& Container)
+		: _InstantaneousModule(Container) {
+		Quick_digital_IO_interrupt::PinMode<Pin, OUTPUT>();
+	}
+	void Restart() override {
+		Quick_digital_IO_interrupt::DigitalToggle<Pin>();
+	}
+	InfoImplement;
+};
+template<uint8_t Pin>
+UID const DigitalToggle<Pin>::ID = UID::Module_DigitalToggle;
+// 此模块可以用ModuleAbort停止监视
+template<uint8_t Pin, typename Monitor>
+class MonitorPin : public _InstantaneousModule {
+	PinListener Listener;
+	// 在Process::ActiveInterrupts中的登记
+	_ActiveList<PinListener>::Node ListenerRegistration{ &Listener };
+#pragma pack(push, 1)
+	struct InfoStruct {
+		uint8_t const NumFields = 3;
+		PodField<UID> const ID{ UID::Field_ID, _ModuleID<MonitorPin>::ID };
+		PodField<uint8_t> const PinField{ UID::Field_Pin, Pin };
+		PodField<UID const*> const MonitorField{ UID::Field_Monitor, &_ModuleID<Monitor>::ID };
+	};
+#pragma pack(pop)
+public:
+	MonitorPin(Process& Container)
+		: _InstantaneousModule(Container), Listener{ Pin, [MonitorPtr = Module::Container.LoadModule<Monitor>()]() {
+														 GBEC_ALLOCATION_SCOPE(MonitorPtr->Container, MonitorPtr);
+														 _StartChild(MonitorPtr, Continuation{});
+													   } } {
+		Quick_digital_IO_interrupt::PinMode<Pin, INPUT>();
+	}
+	void Abort() override {
+		Listener.Pause();
+		Module::Container.ActiveInterrupts.erase(ListenerRegistration);
+	}
+	void Restart() override {
+		Listener.Continue();
+		Module::Container.ActiveInterrupts.insert(ListenerRegistration);
+	}
+	static constexpr bool ReplayOnResume = true;
+	// 监听回调只捕获Monitor模块的指针
+	static constexpr size_t HeapBytes = detail::function_heap_bytes(sizeof(_IDModule_t<Monitor>*));
+	using BackgroundModules = detail::type_list<Monitor>;
+	InfoImplement;
+};
+template<uint8_t Pin, typename Monitor>
+UID const MonitorPin<Pin, Monitor>::ID = UID::Module_MonitorPin;
+template<UID Message>
+struct SerialMessage : _InstantaneousModule {
+protected:
+#pragma pack(push, 1)
+	struct InfoStruct {
+		uint8_t const NumFields = 2;
+		PodField<UID> const ID{ UID::Field_ID, _ModuleID<SerialMessage>::ID };
+		PodField<UID> const MessageField{ UID::Field_Message, Message };
+	};
+#pragma pack(pop)
+public:
+	using _InstantaneousModule::_InstantaneousModule;
+	void Restart() override {
+		EventBatch::Push(Container.Handle, Message);
+	}
+	InfoImplement;
+};
+template<UID Message>
+UID const SerialMessage<Message>::ID = UID::Module_SerialMessage;
+// 被Async包装的延时模块将异步执行，即不等待其结束直接返回继续。但是，对其调用Abort仍可以放弃内容模块。
+template<typename Content>
+struct Async : _InstantaneousModule {
+protected:
+	_IDModule_t<Content>* const ContentPtr = Module::Container.LoadModule<Content>();
+#pragma pack(push, 1)
+	struct InfoStruct {
+		uint8_t const NumFields = 2;
+		PodField<UID> const ID{ UID::Field_ID, _ModuleID<Async>::ID };
+		PodField<UID const*> const ContentField{ UID::Field_Content, &_ModuleID<Content>::ID };
+	};
+#pragma pack(pop)
+public:
+	using _InstantaneousModule::_InstantaneousModule;
+	void Abort() override {
+		_AbortChild(ContentPtr);
+	}
+	void Restart() override {
+		Abort();
+		_StartChild(ContentPtr, Continuation{});
+	}
+	static constexpr uint16_t NumTrials = _IDModule_t<Content>::NumTrials;
+	// 后台内容可能已经执行完毕，只有内容本身可以重放时才重放
+	static constexpr bool ReplayOnResume = _IDModule_t<Content>::ReplayOnResume;
+	using BackgroundModules = detail::type_list<Content>;
+	InfoImplement;
+};
+template<typename Content>
+UID const Async<Content>::ID = UID::Module_Async;
+// 回合是断线重连后自动恢复的最小单元，并且在回合开始时向串口发送信号
+template<UID TrialID, typename Content>
+struct Trial : Module {
+protected:
+	_IDModule_t<Content>* const ContentPtr = Module::Container.LoadModule<Content>();
+	uint8_t const Slot = Module::Container.TrialSlot(TrialID);
+	Continuation FinishCallback;
+	void _Restart() {
+		Abort();
+		EventBatch::Flush();
+		SerialStream.AsyncInvoke(static_cast<uint8_t>(UID::PortC_TrialStart), &Container, TrialID, EventClock::Now());
+	}
+#pragma pack(push, 1)
+	struct InfoStruct {
+		uint8_t const NumFields = 2;
+		PodField<UID> const ID{ UID::Field_ID, TrialID };
+		PodField<UID const*> const ContentField{ UID::Field_Content, &_ModuleID<Content>::ID };
+	};
+#pragma pack(pop)
+public:
+	using Module::Module;
+	void Abort() override {
+		_AbortChild(ContentPtr);
+	}
+	void Restart() override {
+		_Restart();
+		_StartChild(ContentPtr, FinishCallback);
+	}
+	bool Start(Continuation FC) override {
+		uint16_t& Done = Module::Container.TrialsDone(Slot);
+		if (Done) {
+			--Done;
+			return false;
+		}
+		_Restart();
+		if (_StartChild(ContentPtr, FC)) {
+			FinishCallback = FC;
+			return true;
+		}
+		return false;
+	}
+	void SaveCheckpoint(Checkpoint& C) const override {
+		ContentPtr->SaveCheckpoint(C);
+	}
+	// 从断点恢复的是同一个回合，不再检查TrialsDone，也不再发送回合开始
+	bool StartFrom(Checkpoint& C, Continuation FC) override {
+		Abort();
+		if (ContentPtr->StartFrom(C, FC)) {
+			FinishCallback = FC;
+			return true;
+		}
+		return false;
+	}
+	static constexpr uint16_t NumTrials = 1;
+	static constexpr uint8_t MaxTimers = _IDModule_t<Content>::MaxTimers;
+	static constexpr size_t CheckpointBytes = _IDModule_t<Content>::CheckpointBytes;
+	InfoImplement;
+};
+template<UID TrialID, typename Content>
+UID const Trial<TrialID, Content>::ID = TrialID;
+namespace detail {
+	template<UID TrialID, typename Content>
+	struct trial_id<Trial<TrialID, Content>> {
+		static constexpr bool is_trial = true;
+		static constexpr UID value = TrialID;
+	};
+}
+// 将一个清理模块附加到目标模块上，开始、重启、终止或析构此模块前都将先执行清理模块，但目标模块正常结束时则不会清理。清理模块一般应是瞬时的，如果有延时操作则不会等待其完成。
+template<typename Target, typename Cleaner>
+struct CleanWhenAbort : Module {
+protected:
+	_IDModule_t<Target>* const TargetPtr = Module::Container.LoadModule<Target>();
+	_IDModule_t<Cleaner>* const CleanerPtr = Module::Container.LoadModule<Cleaner>();
+	Continuation FinishCallback;
+	// 续点0：目标模块正常结束；续点1：启动清理模块。后者登记在Process::ExtraCleaners中，以便进程终止时清理。
+	enum : uint8_t {
+		TargetFinished,
+		CleanerStart,
+	};
+	Continuation const StartCleaner{ this, CleanerStart };
+	// 在Process::ExtraCleaners中的登记
+	_ActiveList<Continuation const>::Node CleanerRegistration{ &StartCleaner };
+	void _Abort() {
+		_AbortChild(TargetPtr);
+		StartCleaner();
+	}
+#pragma pack(push, 1)
+	struct InfoStruct {
+		uint8_t const NumFields = 3;
+		PodField<UID> const ID{ UID::Field_ID, _ModuleID<CleanWhenAbort>::ID };
+		PodField<UID const*> const TargetField{ UID::Field_Target, &_ModuleID<Target>::ID };
+		PodField<UID const*> const CleanerField{ UID::Field_Cleaner, &_ModuleID<Cleaner>::ID };
+	};
+#pragma pack(pop)
+public:
+	using Module::Module;
+	void Abort() override {
+		_Abort();
+		Module::Container.ExtraCleaners.erase(CleanerRegistration);
+	}
+	void Resume(uint8_t Slot) override {
+		if (Slot == CleanerStart)
+			_StartChild(CleanerPtr, Continuation{});
+		else {
+			Module::Container.ExtraCleaners.erase(CleanerRegistration);
+			FinishCallback();
+		}
+	}
+	void Restart() override {
+		_Abort();
+		if (_StartChild(TargetPtr, Continuation{ this, TargetFinished }))
+			Module::Container.ExtraCleaners.insert(CleanerRegistration);
+	}
+	bool Start(Continuation FC) override {
+		_Abort();
+		if (_StartChild(TargetPtr, Continuation{ this, TargetFinished })) {
+			FinishCallback = FC;
+			Module::Container.ExtraCleaners.insert(CleanerRegistration);
+			return true;
+		}
+		return false;
+	}
+	void SaveCheckpoint(Checkpoint& C) const override {
+		TargetPtr->SaveCheckpoint(C);
+	}
+	// 目标模块从断点继续，清理模块同样重新登记
+	bool StartFrom(Checkpoint& C, Continuation FC) override {
+		_Abort();
+		if (TargetPtr->StartFrom(C, Continuation{ this, TargetFinished })) {
+			FinishCallback = FC;
+			Module::Container.ExtraCleaners.insert(CleanerRegistration);
+			return true;
+		}
+		return false;
+	}
+	~CleanWhenAbort() {
+		StartCleaner();
+		Module::Container.ExtraCleaners.erase(CleanerRegistration);
+	}
+	static constexpr uint16_t NumTrials = _IDModule_t<Target>::NumTrials;
+	static constexpr uint8_t MaxTimers = _IDModule_t<Target>::MaxTimers;
+	static constexpr size_t CheckpointBytes = _IDModule_t<Target>::CheckpointBytes;
+	using BackgroundModules = detail::type_list<Cleaner>;
+	InfoImplement;
+};
+template<typename Target, typename Cleaner>
+UID const CleanWhenAbort<Target, Cleaner>::ID = UID::Module_CleanWhenAbort;
+template<UID UniqueID = UID::Module_DynamicSlot>
+struct DynamicSlot : Module {
+protected:
+#pragma pack(push, 1)
+	struct InfoStruct {
+		uint8_t const NumFields = 1;
+		PodField<UID> const ID{ UID::Field_ID, _ModuleID<DynamicSlot>::ID };
+	};
+#pragma pack(pop)
+public:
+	using Module::Module;
+	void Abort() override {
+		if (ContentPtr)
+			ContentPtr->Abort();
+	}
+	void Restart() override {
+		if (ContentPtr)
+			ContentPtr->Restart();
+	}
+	bool Start(Continuation FC) override {
+		return ContentPtr && ContentPtr->Start(FC);
+	}
+	// 槽位只存指针。可装入的内容模块经Load的Dependencies计入同一场地，不另占堆内存
+	Module* ContentPtr = nullptr;
+	InfoImplement;
+	template<typename Content>
+	struct Load : _InstantaneousModule {
+		using Dependencies = detail::type_list<DynamicSlot, Content>;
+		// Content在槽位执行时才启动，无从得知槽位所在的前台，按后台估计
+		using BackgroundModules = detail::type_list<Content>;
+
+	protected:
+		DynamicSlot* const SlotPtr = Module::Container.LoadModule<DynamicSlot>();
+		Module* const ContentPtr;
+#pragma pack(push, 1)
+		struct InfoStruct {
+			uint8_t const NumFields = 3;
+			PodField<UID> const ID{ UID::Field_ID, _ModuleID<Load>::ID };
+			PodField<UID const*> const Slot{ UID::Field_Slot, &_ModuleID<DynamicSlot>::ID };
+			PodField<UID const*> ContentField;
+			constexpr InfoStruct()
+				: ContentField{ UID::Field_Content, &_ModuleID<Content>::ID } {
+			}
+		};
+#pragma pack(pop)
+	public:
+		//SAM编译器bug：使用了内联struct模板参数的成员初始化只能写在构造方法里，不能直接成员初始化，成员初始化无法访问内联模板参数
+		Load(Process& Container)
+			: _InstantaneousModule(Container), ContentPtr{ Container.LoadModule<Content>() } {
+		}
+		void Restart() override {
+			SlotPtr->ContentPtr = ContentPtr;
+		}
+		static constexpr bool ReplayOnResume = true;
+		InfoImplement;
+	};
+	struct Clear : _InstantaneousModule {
+		using Dependencies = detail::type_list<DynamicSlot>;
+
+	protected:
+		DynamicSlot* const SlotPtr = Module::Container.LoadModule<DynamicSlot>();
+#pragma pack(push, 1)
+		struct InfoStruct {
+			uint8_t const NumFields = 2;
+			PodField<UID> const ID{ UID::Field_ID, _ModuleID<Clear>::ID };
+			PodField<UID const*> const Slot{ UID::Field_Slot, &_ModuleID<DynamicSlot>::ID };
+		};
+#pragma pack(pop)
+	public:
+		using _InstantaneousModule::_InstantaneousModule;
+		void Restart() override {
+			SlotPtr->ContentPtr = nullptr;
+		}
+		static constexpr bool ReplayOnResume = true;
+		InfoImplement;
+	};
+};
+template<UID UniqueID>
+UID const DynamicSlot<UniqueID>::ID = UniqueID;
+template<UID UniqueID>
+template<typename Content>
+UID const DynamicSlot<UniqueID>::Load<Content>::ID = UID::Module_LoadSlot;
+template<UID UniqueID>
+UID const DynamicSlot<UniqueID>::Clear::ID = UID::Module_ClearSlot;
+
+template<typename TModule>
+uint16_t Session(Process* P) {
+	static_assert(SessionBudget<TModule>::Ram <= GBEC_SESSION_RAM_BUDGET, "会话的内存估计超出GBEC_SESSION_RAM_BUDGET");
+	static_assert(SessionBudget<TModule>::Timers <= GBEC_SESSION_TIMER_BUDGET, "会话同时占用的计时器数可能超出GBEC_SESSION_TIMER_BUDGET");
+	static_assert(Checkpoint::HeaderBytes + _IDModule_t<TModule>::CheckpointBytes <= GBEC_CHECKPOINT_CAPACITY, "会话的断点可能超出GBEC_CHECKPOINT_CAPACITY");
+	return P->LoadStartModule<TModule>();
+};
+#define Pin static constexpr uint8_t
+template<typename Target>
+UID const& _ModuleID<Target>::ID = Target::ID;
+
+// 将模块绑定到指定UID，方便循环引用，并在返回信息中显示自定义名称
+#define AssignModuleID(TargetModule, TargetID) \
+	template<> \
+	struct _ModuleID<TargetModule> { \
+		static UID const ID; \
+	}; \
+	UID const _ModuleID<TargetModule>::ID = TargetID; \
+	template<> \
+	struct _IDModule<IDModule<TargetID>> { \
+		using type = TargetModule; \
+	}; \
+	template<> \
+	struct _ModuleID<IDModule<TargetID>> : _ModuleID<TargetModule> { \
 	};
\ No newline at end of file
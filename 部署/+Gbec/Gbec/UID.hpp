@@ -1,209 +1,226 @@
-#pragma once
-#include <stdint.h>
-/* 本文件定义了所有的UID枚举值，作为模块、异常、信息字段等的唯一标识符，在Arduino端和PC端之间传递信息时使用，且必须保持一致。
-用户可以在此文件中添加自定义的UID枚举值，但请勿修改已有的枚举值，否则可能导致Arduino端和PC端之间无法正确通信。
-*/
-enum class UID : uint8_t {
-	// Arduino提供的服务端口
-
-	PortA_PointerSize,
-	PortA_CreateProcess,
-	PortA_StartModule,
-	PortA_RestoreModule,
-	PortA_PauseProcess,
-	PortA_ContinueProcess,
-	PortA_AbortProcess,
-	PortA_GetInformation,
-	PortA_DeleteProcess,
-	PortA_AllProcesses,
-	PortA_RandomSeed,
-	PortA_IsReady,
-	PortA_ProcessValid,
-
-	// Computer提供的服务端口
-
-	PortC_ProcessFinished,
-	PortC_Signal,
-	PortC_TrialStart,
-	PortC_Exception,
-	PortC_ImReady,
-
-	// 运行时异常
-
-	Exception_Success,
-	Exception_InvalidProcess,
-	Exception_MethodNotSupported,
-	Exception_StillRunning,
-	Exception_ProcessNotRunning,
-	Exception_ProcessNotPaused,
-	Exception_ProcessNotIdle,
-	Exception_ProcessFinished,
-	Exception_BrokenStartArguments,
-	Exception_BrokenRestoreArguments,
-	Exception_MethodNotImplemented,
-	Exception_InvalidModule,
-
-	// 信息字段
-
-	Field_After,
-	Field_Do,
-	Field_ID,
-	Field_RandomDuration,
-	Field_Duration,
-	Field_AbortStep,
-	Field_StartModule,
-	Field_Modules,
-	Field_Range,
-	Field_Target,
-	Field_Pin,
-	Field_Monitor,
-	Field_Content,
-	Field_Message,
-	Field_HighOrLow,
-	Field_Cleaner,
-	Field_Period,
-	Field_Times,
-	Field_PeriodA,
-	Field_PeriodB,
-	Field_ContentA,
-	Field_ContentB,
-	Field_TargetID,
-	Field_Slot,
-	Field_Value,
-	Field_Unit,
-
-	// 表列
-
-	Column_SubSteps,
-	Column_Repeats,
-	Column_Module,
-
-	// 信息字段数据类型
-
-	Type_Bool,
-	Type_UInt8,
-	Type_UInt16,
-	Type_UInt32,
-	Type_UID,
-	Type_Array,
-	Type_Struct,
-	Type_Seconds,
-	Type_Milliseconds,
-	Type_Microseconds,
-	Type_Infinite,
-	Type_Table,
-	Type_Pointer,
-	Type_Map,
-
-	// 进程状态
-
-	State_Ready,
-	State_Running,
-	State_Paused,
-	State_Aborted,
-	State_Finished,
-	State_Normal,
-	State_Repeat,
-	State_Restore,
-	State_Idle,
-
-	// 信号事件
-
-	Event_TrialStart,
-	Event_ConnectionReset,
-	Event_MonitorHit,
-	Event_MonitorMiss,
-	Event_ProcessPaused,
-	Event_ProcessContinue,
-	Event_ProcessAborted,
-	Event_AudioUp,
-	Event_AudioDown,
-	Event_LightUp,
-	Event_LightDown,
-	Event_Water,
-	Event_AirPuff,
-	Event_HitCount,
-	Event_HFImage,
-	Event_LFImage,
-	Event_Optogenetic,
-	Event_Image,
-	Event_LowUp,
-	Event_LowDown,
-	Event_HighUp,
-	Event_HighDown,
-	Event_FlareUp,
-	Event_FlareDown,
-
-	// 测试
-
-	Test_BlueLed,
-	Test_WaterPump,
-	Test_CapacitorReset,
-	Test_CapacitorMonitor,
-	Test_CD1,
-	Test_ActiveBuzzer,
-	Test_AirPump,
-	Test_HostAction,
-	Test_SquareWave,
-	Test_RandomFlash,
-	Test_LowTone,
-	Test_HighTone,
-	Test_Optogenetic,
-	Test_Flare,
-
-	// 回合
-
-	Trial_Invalid,
-	Trial_AudioWater,
-	Trial_LightWater,
-	Trial_AudioOnly,
-	Trial_LightOnly,
-	Trial_WaterOnly,
-	Trial_AudioWaterFlare,
-	Trial_Empty,
-	
-	// 持续时间类型
-
-	Integer_Random,
-	Duration_Infinite,
-
-	// 基础模块
-
-	Module_Sequential,
-	Module_RandomSequential,
-	Module_Delay,
-	Module_Abort,
-	Module_Restart,
-	Module_Randomize,
-	Module_Skip,
-	Module_MonitorPin,
-	Module_SerialMessage,
-	Module_DigitalWrite,
-	Module_CleanWhenAbort,
-	Module_Async,
-	Module_RepeatEvery,
-	Module_DoubleRepeat,
-	Module_Repeat,
-	Module_DigitalToggle,
-	Module_AssignModuleID,
-	Module_ReferModuleID,
-	Module_DynamicSlot,
-	Module_LoadSlot,
-	Module_ClearSlot,
-	Module_ResponseWindow,
-	Module_RandomInteger,
-	Module_ConstantInteger,
-
-	// 主机动作
-
-	Host_GratingImage,
-	Host_StartRecord,
-
-	// 会话
-
-	Session_AudioWater,
-	Session_LightWater,
-	Session_LAuW,
-	Session_AudioWaterFlare,
-	Session_Empty,
+#pragma once
+#include <stdint.h>
+/* 本文件定义了所有的UID枚举值，作为模块、异常、信息字段等的唯一标识符，在Arduino端和PC端之间传递信息时使用，且必须保持一致。
+用户可以在此文件中添加自定义的UID枚举值，但请勿修改已有的枚举值，否则可能导致Arduino端和PC端之间无法正确通信。
+*/
+enum class UID : uint8_t {
+	// Arduino提供的服务端口
+
+	PortA_PointerSize,
+	PortA_CreateProcess,
+	PortA_StartModule,
+	PortA_RestoreModule,
+	PortA_PauseProcess,
+	PortA_ContinueProcess,
+	PortA_AbortProcess,
+	PortA_GetInformation,
+	PortA_DeleteProcess,
+	PortA_AllProcesses,
+	PortA_RandomSeed,
+	PortA_IsReady,
+	PortA_ProcessValid,
+	PortA_StreamStatistics,
+	PortA_SetBaudRate,
+	PortA_ConfirmBaudRate,
+	PortA_AllocationCount,
+	PortA_SetEventBatch,
+	PortA_ProcessHandle,
+	PortA_ModuleAllocations,
+	PortA_TimerStatistics,
+	PortA_GetCheckpoint,
+	PortA_RestoreCheckpoint,
+
+	// Computer提供的服务端口
+
+	PortC_ProcessFinished,
+	PortC_Signal,
+	PortC_TrialStart,
+	PortC_Exception,
+	PortC_ImReady,
+	PortC_SignalBatch,
+
+	// 运行时异常
+
+	Exception_Success,
+	Exception_InvalidProcess,
+	Exception_MethodNotSupported,
+	Exception_StillRunning,
+	Exception_ProcessNotRunning,
+	Exception_ProcessNotPaused,
+	Exception_ProcessNotIdle,
+	Exception_ProcessFinished,
+	Exception_BrokenStartArguments,
+	Exception_BrokenRestoreArguments,
+	Exception_MethodNotImplemented,
+	Exception_InvalidModule,
+	Exception_InvalidBaudRate,
+	Exception_InvalidEventBatch,
+	Exception_ModuleNotInLayout,
+	Exception_CheckpointOverflow,
+
+	// 信息字段
+
+	Field_After,
+	Field_Do,
+	Field_ID,
+	Field_RandomDuration,
+	Field_Duration,
+	Field_AbortStep,
+	Field_StartModule,
+	Field_Modules,
+	Field_Range,
+	Field_Target,
+	Field_Pin,
+	Field_Monitor,
+	Field_Content,
+	Field_Message,
+	Field_HighOrLow,
+	Field_Cleaner,
+	Field_Period,
+	Field_Times,
+	Field_PeriodA,
+	Field_PeriodB,
+	Field_ContentA,
+	Field_ContentB,
+	Field_TargetID,
+	Field_Slot,
+	Field_Value,
+	Field_Unit,
+	Field_RandomSeed,
+	Field_RandomDraws,
+
+	// 表列
+
+	Column_SubSteps,
+	Column_Repeats,
+	Column_Module,
+
+	// 信息字段数据类型
+
+	Type_Bool,
+	Type_UInt8,
+	Type_UInt16,
+	Type_UInt32,
+	Type_UID,
+	Type_Array,
+	Type_Struct,
+	Type_Seconds,
+	Type_Milliseconds,
+	Type_Microseconds,
+	Type_Infinite,
+	Type_Table,
+	Type_Pointer,
+	Type_Map,
+
+	// 进程状态
+
+	State_Ready,
+	State_Running,
+	State_Paused,
+	State_Aborted,
+	State_Finished,
+	State_Normal,
+	State_Repeat,
+	State_Restore,
+	State_Idle,
+
+	// 信号事件
+
+	Event_TrialStart,
+	Event_ConnectionReset,
+	Event_MonitorHit,
+	Event_MonitorMiss,
+	Event_ProcessPaused,
+	Event_ProcessContinue,
+	Event_ProcessAborted,
+	Event_AudioUp,
+	Event_AudioDown,
+	Event_LightUp,
+	Event_LightDown,
+	Event_Water,
+	Event_AirPuff,
+	Event_HitCount,
+	Event_HFImage,
+	Event_LFImage,
+	Event_Optogenetic,
+	Event_Image,
+	Event_LowUp,
+	Event_LowDown,
+	Event_HighUp,
+	Event_HighDown,
+	Event_FlareUp,
+	Event_FlareDown,
+
+	// 测试
+
+	Test_BlueLed,
+	Test_WaterPump,
+	Test_CapacitorReset,
+	Test_CapacitorMonitor,
+	Test_CD1,
+	Test_ActiveBuzzer,
+	Test_AirPump,
+	Test_HostAction,
+	Test_SquareWave,
+	Test_RandomFlash,
+	Test_LowTone,
+	Test_HighTone,
+	Test_Optogenetic,
+	Test_Flare,
+
+	// 回合
+
+	Trial_Invalid,
+	Trial_AudioWater,
+	Trial_LightWater,
+	Trial_AudioOnly,
+	Trial_LightOnly,
+	Trial_WaterOnly,
+	Trial_AudioWaterFlare,
+	Trial_Empty,
+	
+	// 持续时间类型
+
+	Integer_Random,
+	Duration_Infinite,
+
+	// 基础模块
+
+	Module_Sequential,
+	Module_RandomSequential,
+	Module_Delay,
+	Module_Abort,
+	Module_Restart,
+	Module_Randomize,
+	Module_Skip,
+	Module_MonitorPin,
+	Module_SerialMessage,
+	Module_DigitalWrite,
+	Module_CleanWhenAbort,
+	Module_Async,
+	Module_RepeatEvery,
+	Module_DoubleRepeat,
+	Module_Repeat,
+	Module_DigitalToggle,
+	Module_AssignModuleID,
+	Module_ReferModuleID,
+	Module_DynamicSlot,
+	Module_LoadSlot,
+	Module_ClearSlot,
+	Module_ResponseWindow,
+	Module_RandomInteger,
+	Module_ConstantInteger,
+
+	// 主机动作
+
+	Host_GratingImage,
+	Host_StartRecord,
+
+	// 会话
+
+	Session_AudioWater,
+	Session_LightWater,
+	Session_LAuW,
+	Session_AudioWaterFlare,
+	Session_Empty,
 };
\ No newline at end of file